@@ -0,0 +1,152 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Benchmarks that do not need a display: theme loading and the
+ * rendering of a gauge into an image surface, i.e. what AgwGauge does
+ * in its draw() method. */
+
+#include "bench.h"
+#include "../src/agw-gauge-renderer.h"
+#include <math.h>
+
+#define STEPS   120
+
+
+typedef struct {
+    AgwGaugeRenderer *  renderer;
+    cairo_t *           cr;
+    gint                size;
+} RenderData;
+
+
+static gchar *theme_dir = NULL;
+
+static const struct {
+    AgwGaugeHandMode    mode;
+    const gchar *       name;
+} modes[] = {
+    { AGW_GAUGE_HAND_MODE_VECTOR, "vector" },
+    { AGW_GAUGE_HAND_MODE_BITMAP, "bitmap" },
+    { AGW_GAUGE_HAND_MODE_ATLAS,  "atlas" },
+};
+
+static const gint sizes[] = { 64, 200, 512 };
+
+
+static void
+load_theme(gpointer user_data, guint iteration)
+{
+    AgwGaugeRenderer *renderer = agw_gauge_renderer_new();
+    cairo_rectangle_int_t area;
+
+    if (!agw_gauge_renderer_set_theme(renderer, theme_dir, NULL)) {
+        g_error("Unable to load theme from '%s'", theme_dir);
+    }
+
+    /* Hands are loaded lazily: include the minute hand */
+    agw_gauge_renderer_get_hand_area(renderer, 100, AGW_GAUGE_HAND_MINUTE, 0, &area);
+    g_object_unref(renderer);
+}
+
+static gdouble
+get_angle(guint iteration)
+{
+    return (iteration % STEPS) * 2*G_PI / STEPS;
+}
+
+static void
+render_frame(gpointer user_data, guint iteration)
+{
+    RenderData *data = user_data;
+    gdouble angles[] = { NAN, get_angle(iteration), NAN };
+
+    agw_gauge_renderer_render(data->renderer, data->cr, data->size,
+                              angles, G_N_ELEMENTS(angles));
+}
+
+static void
+render_hand(gpointer user_data, guint iteration)
+{
+    RenderData *data = user_data;
+
+    agw_gauge_renderer_render_hand(data->renderer, data->cr, data->size,
+                                   AGW_GAUGE_HAND_MINUTE, get_angle(iteration));
+}
+
+static void
+bench_render(AgwGaugeHandMode mode, const gchar *mode_name, gint size)
+{
+    RenderData data;
+    cairo_surface_t *surface;
+    gchar *name;
+    guint n;
+
+    data.renderer = agw_gauge_renderer_new();
+    agw_gauge_renderer_set_theme(data.renderer, theme_dir, NULL);
+    agw_gauge_renderer_set_hand_mode(data.renderer, mode);
+    agw_gauge_renderer_set_hand_steps(data.renderer, STEPS);
+    data.size = size;
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+    data.cr = cairo_create(surface);
+
+    /* Warm up the caches at every angle, so the atlas is complete */
+    for (n = 0; n < STEPS; ++n) {
+        render_frame(&data, n);
+    }
+
+    name = g_strdup_printf("render-frame-%s-%d", mode_name, size);
+    bench_time(name, 500, render_frame, &data);
+    g_free(name);
+
+    name = g_strdup_printf("render-hand-%s-%d", mode_name, size);
+    bench_time(name, 500, render_hand, &data);
+    g_free(name);
+
+    cairo_destroy(data.cr);
+    cairo_surface_destroy(surface);
+    g_object_unref(data.renderer);
+}
+
+int
+main(int argc, char **argv)
+{
+    AgwGaugeRenderer *holder;
+    guint m, s;
+
+    bench_init("renderer", &argc, &argv);
+    theme_dir = g_build_filename(SRCDIR, "assets", NULL);
+
+    /* Cold: the theme cache is emptied when the last renderer dies */
+    bench_time("theme-load-cold", 20, load_theme, NULL);
+
+    /* Cached: another user keeps the theme alive */
+    holder = agw_gauge_renderer_new();
+    agw_gauge_renderer_set_theme(holder, theme_dir, NULL);
+    bench_time("theme-load-cached", 200, load_theme, NULL);
+    g_object_unref(holder);
+
+    for (m = 0; m < G_N_ELEMENTS(modes); ++m) {
+        for (s = 0; s < G_N_ELEMENTS(sizes); ++s) {
+            bench_render(modes[m].mode, modes[m].name, sizes[s]);
+        }
+    }
+
+    g_free(theme_dir);
+    return bench_end();
+}
@@ -0,0 +1,229 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Benchmarks of the widgets themselves. GTK 3 cannot create widgets
+ * without a display, so this suite is skipped when none is available
+ * (run it under xvfb-run or broadwayd on headless machines). Widgets
+ * are drawn into image surfaces from a GtkOffscreenWindow, so nothing
+ * appears on screen. */
+
+#include "bench.h"
+#include "../src/agw.h"
+
+#define N_GAUGES    200
+
+
+typedef struct {
+    GtkWidget *         widget;
+    cairo_t *           cr;
+} WidgetData;
+
+
+static gchar *theme_dir = NULL;
+
+
+static void
+flush_events(void)
+{
+    while (gtk_events_pending()) {
+        gtk_main_iteration();
+    }
+}
+
+static GtkWidget *
+new_gauge(void)
+{
+    GtkWidget *gauge = agw_gauge_new();
+
+    gtk_range_set_range(GTK_RANGE(gauge), -2000, 2000);
+    if (!agw_gauge_set_theme(AGW_GAUGE(gauge), theme_dir, NULL)) {
+        g_error("Unable to load theme from '%s'", theme_dir);
+    }
+
+    return gauge;
+}
+
+static void
+set_gauge_value(gpointer user_data, guint iteration)
+{
+    WidgetData *data = user_data;
+
+    /* Raw encoder counts, far away from the limits */
+    agw_gauge_set_value(AGW_GAUGE(data->widget), 40000000. + iteration * 7);
+}
+
+static void
+set_label_value(gpointer user_data, guint iteration)
+{
+    WidgetData *data = user_data;
+
+    agw_numeric_label_set_value(AGW_NUMERIC_LABEL(data->widget), iteration * 0.001);
+}
+
+static void
+draw_widget(gpointer user_data, guint iteration)
+{
+    WidgetData *data = user_data;
+
+    gtk_range_set_value(GTK_RANGE(data->widget), (iteration % 4000) - 2000.);
+    gtk_widget_draw(data->widget, data->cr);
+}
+
+static void
+bench_set_value(void)
+{
+    WidgetData data;
+    GtkWidget *window;
+    cairo_surface_t *surface;
+
+    /* Not on screen: only the value handling is measured */
+    data.widget = g_object_ref_sink(new_gauge());
+    bench_time("gauge-set-value-hidden", 1000000, set_gauge_value, &data);
+    g_object_unref(data.widget);
+
+    /* Drawn once: every update also computes the damaged area */
+    window = gtk_offscreen_window_new();
+    data.widget = new_gauge();
+    gtk_widget_set_size_request(data.widget, 200, 200);
+    gtk_container_add(GTK_CONTAINER(window), data.widget);
+    gtk_widget_show_all(window);
+    flush_events();
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 200, 200);
+    data.cr = cairo_create(surface);
+    gtk_widget_draw(data.widget, data.cr);
+    bench_time("gauge-set-value-shown", 100000, set_gauge_value, &data);
+    cairo_destroy(data.cr);
+    cairo_surface_destroy(surface);
+    gtk_widget_destroy(window);
+}
+
+static void
+bench_draw(gint size)
+{
+    WidgetData data;
+    GtkWidget *window;
+    cairo_surface_t *surface;
+    gchar *name;
+
+    window = gtk_offscreen_window_new();
+    data.widget = new_gauge();
+    gtk_widget_set_size_request(data.widget, size, size);
+    gtk_container_add(GTK_CONTAINER(window), data.widget);
+    gtk_widget_show_all(window);
+    flush_events();
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+    data.cr = cairo_create(surface);
+
+    name = g_strdup_printf("gauge-draw-%d", size);
+    bench_time(name, 500, draw_widget, &data);
+    g_free(name);
+
+    cairo_destroy(data.cr);
+    cairo_surface_destroy(surface);
+    gtk_widget_destroy(window);
+}
+
+static void
+bench_label(void)
+{
+    WidgetData data;
+    GtkWidget *window;
+
+    window = gtk_offscreen_window_new();
+    data.widget = agw_numeric_label_new();
+    agw_numeric_label_set_format(AGW_NUMERIC_LABEL(data.widget), "%.3f");
+    gtk_container_add(GTK_CONTAINER(window), data.widget);
+    gtk_widget_show_all(window);
+    flush_events();
+
+    bench_time("label-set-value", 100000, set_label_value, &data);
+
+    gtk_widget_destroy(window);
+}
+
+static void
+bench_memory(void)
+{
+    GtkWidget *window, *grid, *gauge;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    gsize before, after;
+    gint n;
+
+    /* Warm up: the first gauge pays for the theme and the GTK caches */
+    window = gtk_offscreen_window_new();
+    gtk_container_add(GTK_CONTAINER(window), new_gauge());
+    gtk_widget_show_all(window);
+    flush_events();
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 100, 100);
+    cr = cairo_create(surface);
+    gtk_widget_draw(window, cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    gtk_widget_destroy(window);
+
+    before = bench_get_rss();
+
+    window = gtk_offscreen_window_new();
+    grid = gtk_grid_new();
+    gtk_container_add(GTK_CONTAINER(window), grid);
+    for (n = 0; n < N_GAUGES; ++n) {
+        gauge = new_gauge();
+        gtk_widget_set_size_request(gauge, 100, 100);
+        gtk_grid_attach(GTK_GRID(grid), gauge, n % 20, n / 20, 1, 1);
+    }
+    gtk_widget_show_all(window);
+    flush_events();
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 2000, 1000);
+    cr = cairo_create(surface);
+    gtk_widget_draw(window, cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    after = bench_get_rss();
+    bench_record("gauge-memory", N_GAUGES,
+                 after > before ? (gdouble) (after - before) / N_GAUGES : 0,
+                 "bytes");
+
+    gtk_widget_destroy(window);
+}
+
+int
+main(int argc, char **argv)
+{
+    bench_init("widgets", &argc, &argv);
+
+    if (!gtk_init_check(&argc, &argv)) {
+        return bench_skip("no display available");
+    }
+
+    agw_init();
+    theme_dir = g_build_filename(SRCDIR, "assets", NULL);
+
+    bench_set_value();
+    bench_draw(64);
+    bench_draw(200);
+    bench_draw(512);
+    bench_label();
+    bench_memory();
+
+    g_free(theme_dir);
+    return bench_end();
+}
@@ -0,0 +1,257 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+static gchar *suite = NULL;
+static gchar *output = NULL;
+static GString *results = NULL;
+
+
+static void
+append_string(GString *json, const gchar *string)
+{
+    const gchar *p;
+
+    g_string_append_c(json, '"');
+    for (p = string; *p != '\0'; ++p) {
+        if (*p == '"' || *p == '\\') {
+            g_string_append_c(json, '\\');
+            g_string_append_c(json, *p);
+        } else if ((guchar) *p < 0x20) {
+            g_string_append_printf(json, "\\u%04x", (guint) *p);
+        } else {
+            g_string_append_c(json, *p);
+        }
+    }
+    g_string_append_c(json, '"');
+}
+
+static gint
+write_json(gboolean skipped, const gchar *reason)
+{
+    GString *json;
+    GError *error;
+    gint status;
+
+    json = g_string_new("{ \"suite\": ");
+    append_string(json, suite);
+    g_string_append_printf(json, ", \"skipped\": %s", skipped ? "true" : "false");
+    if (reason != NULL) {
+        g_string_append(json, ", \"reason\": ");
+        append_string(json, reason);
+    }
+    g_string_append(json, ", \"results\": [");
+    if (results != NULL && results->len > 0) {
+        g_string_append(json, results->str);
+        g_string_append(json, "\n");
+    }
+    g_string_append(json, "] }\n");
+
+    status = 0;
+    if (output == NULL) {
+        fputs(json->str, stdout);
+    } else {
+        error = NULL;
+        if (!g_file_set_contents(output, json->str, json->len, &error)) {
+            g_printerr("%s\n", error->message);
+            g_error_free(error);
+            status = 1;
+        }
+    }
+
+    g_string_free(json, TRUE);
+    return status;
+}
+
+static void
+cleanup(void)
+{
+    g_string_free(results, TRUE);
+    results = NULL;
+    g_free(suite);
+    suite = NULL;
+    g_free(output);
+    output = NULL;
+}
+
+
+/**
+ * bench_init:
+ * @name: name of the benchmark suite
+ * @argc: pointer to the argc of main()
+ * @argv: pointer to the argv of main()
+ *
+ * Parses the common command line options and starts collecting
+ * results. Exits on invalid options.
+ **/
+void
+bench_init(const gchar *name, gint *argc, gchar ***argv)
+{
+    GOptionEntry options[] = {{
+        "output",                   /* long_name */
+        'o',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_FILENAME,      /* arg */
+        &output,                    /* arg_data */
+        "Write the JSON results to FILE instead of stdout",
+        "FILE"                      /* arg_description */
+    }, {
+        NULL
+    }};
+    GOptionContext *context;
+    GError *error;
+
+    suite = g_strdup(name);
+    results = g_string_new(NULL);
+
+    context = g_option_context_new(NULL);
+    g_option_context_add_main_entries(context, options, NULL);
+    g_option_context_set_ignore_unknown_options(context, TRUE);
+    error = NULL;
+    if (!g_option_context_parse(context, argc, argv, &error)) {
+        g_printerr("%s\n", error->message);
+        g_error_free(error);
+        exit(1);
+    }
+    g_option_context_free(context);
+}
+
+/**
+ * bench_record:
+ * @name: name of the measurement
+ * @iterations: number of iterations the value refers to
+ * @value: the measured value
+ * @unit: unit of @value
+ *
+ * Adds a measurement to the results.
+ **/
+void
+bench_record(const gchar *name, guint iterations, gdouble value, const gchar *unit)
+{
+    gchar number[G_ASCII_DTOSTR_BUF_SIZE];
+
+    if (results->len > 0) {
+        g_string_append_c(results, ',');
+    }
+    g_string_append(results, "\n  { \"name\": ");
+    append_string(results, name);
+    g_string_append_printf(results, ", \"iterations\": %u, \"value\": ", iterations);
+    /* JSON wants a dot as decimal separator, whatever the locale */
+    g_string_append(results, g_ascii_formatd(number, sizeof(number), "%.6g", value));
+    g_string_append(results, ", \"unit\": ");
+    append_string(results, unit);
+    g_string_append(results, " }");
+}
+
+/**
+ * bench_time:
+ * @name: name of the measurement
+ * @iterations: how many times @func must be called
+ * @func: the function to benchmark
+ * @user_data: data to pass to @func
+ *
+ * Calls @func once to warm up caches, then @iterations times while
+ * measuring the elapsed time. The mean time per call is recorded in
+ * microseconds.
+ *
+ * Returns: the mean time per call, in microseconds
+ **/
+gdouble
+bench_time(const gchar *name, guint iterations, BenchFunc func, gpointer user_data)
+{
+    gint64 start, elapsed;
+    gdouble mean;
+    guint n;
+
+    func(user_data, 0);
+
+    start = g_get_monotonic_time();
+    for (n = 0; n < iterations; ++n) {
+        func(user_data, n);
+    }
+    elapsed = g_get_monotonic_time() - start;
+
+    mean = (gdouble) elapsed / iterations;
+    bench_record(name, iterations, mean, "us");
+    return mean;
+}
+
+/**
+ * bench_get_rss:
+ *
+ * Gets the resident set size of the current process.
+ *
+ * Returns: the resident memory in bytes, 0 if not available
+ **/
+gsize
+bench_get_rss(void)
+{
+    gchar *content;
+    gulong size, resident;
+    gsize rss;
+
+    if (!g_file_get_contents("/proc/self/statm", &content, NULL, NULL)) {
+        return 0;
+    }
+
+    rss = 0;
+    if (sscanf(content, "%lu %lu", &size, &resident) == 2) {
+        rss = (gsize) resident * sysconf(_SC_PAGESIZE);
+    }
+    g_free(content);
+
+    return rss;
+}
+
+/**
+ * bench_end:
+ *
+ * Prints the results.
+ *
+ * Returns: the exit status of the program
+ **/
+gint
+bench_end(void)
+{
+    gint status = write_json(FALSE, NULL);
+
+    cleanup();
+    return status;
+}
+
+/**
+ * bench_skip:
+ * @reason: why the suite cannot be run
+ *
+ * Prints an empty result set marked as skipped.
+ *
+ * Returns: %BENCH_EXIT_SKIP, to be used as exit status
+ **/
+gint
+bench_skip(const gchar *reason)
+{
+    g_string_truncate(results, 0);
+    write_json(TRUE, reason);
+    cleanup();
+    return BENCH_EXIT_SKIP;
+}
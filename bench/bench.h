@@ -0,0 +1,64 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Tiny helpers shared by the benchmark programs.
+ *
+ * Every program collects its measurements with bench_time_*() or
+ * bench_record() and prints them as a single JSON document on stdout
+ * (or in the file passed with --output) when calling bench_end():
+ *
+ *   { "suite": "renderer", "skipped": false, "results": [
+ *       { "name": "...", "iterations": 1000, "value": 12.3, "unit": "us" },
+ *       ... ] }
+ *
+ * A program that cannot run (e.g. no display is available) exits with
+ * status 77, so meson reports the benchmark as skipped.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <glib.h>
+
+
+#define BENCH_EXIT_SKIP 77
+
+G_BEGIN_DECLS
+
+typedef void    (*BenchFunc)                (gpointer       user_data,
+                                             guint          iteration);
+
+void            bench_init                  (const gchar *  suite,
+                                             gint *         argc,
+                                             gchar ***      argv);
+void            bench_record                (const gchar *  name,
+                                             guint          iterations,
+                                             gdouble        value,
+                                             const gchar *  unit);
+gdouble         bench_time                  (const gchar *  name,
+                                             guint          iterations,
+                                             BenchFunc      func,
+                                             gpointer       user_data);
+gsize           bench_get_rss               (void);
+gint            bench_end                   (void);
+gint            bench_skip                  (const gchar *  reason);
+
+G_END_DECLS
+
+
+#endif /* __BENCH_H__ */
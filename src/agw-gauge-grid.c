@@ -0,0 +1,857 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * SECTION:agw-gauge-grid
+ * @short_description: Many gauges drawn by a single widget
+ *
+ * #AgwGaugeGrid shows #AgwGaugeGrid:n-gauges gauges, all with the same
+ * theme, in a grid of #AgwGaugeGrid:columns columns. It is meant for
+ * status walls: there are no child widgets to allocate and all the
+ * gauges are drawn in the same pass by a single #AgwGaugeRenderer, so
+ * every cell shares the same rasterized background and foreground
+ * layers.
+ *
+ * The values are set by index, one at a time with
+ * agw_gauge_grid_set_value() or in bulk with agw_gauge_grid_set_values().
+ * All the gauges share the same limits, set with
+ * agw_gauge_grid_set_range(), and the values are mapped to angles as
+ * in #AgwGauge, with the origin at north. Only the area swept by the
+ * hands that moved is invalidated and only the cells inside that area
+ * are redrawn, so the per-frame work depends on how many values
+ * changed, not on the size of the grid.
+ **/
+
+/**
+ * AgwGaugeGrid:
+ *
+ * All fields are private and should not be used directly.
+ * Use its public methods instead.
+ **/
+
+#include "agw-gauge-grid.h"
+#include "agw-gauge-theme.h"
+#include "agw-perf.h"
+#include <math.h>
+#include <string.h>
+
+
+typedef struct {
+    gint                columns;
+    gint                rows;
+    gint                cell_width;
+    gint                cell_height;
+    gint                size;
+} AgwGaugeGridLayout;
+
+typedef struct {
+    AgwGaugeRenderer *  renderer;
+    guint               n_gauges;
+    guint               columns;
+    gdouble             lower;
+    gdouble             upper;
+    gdouble *           values;
+
+    /* Whether the hands are on screen at their drawn_angles */
+    gboolean            drawn;
+    gdouble *           drawn_angles;
+
+    /* Cells to draw in the current pass: cell n is selected when
+     * marks[n] is equal to pass */
+    guint *             marks;
+    guint               pass;
+    guint *             cells;
+} AgwGaugeGridPrivate;
+
+struct _AgwGaugeGrid {
+    GtkWidget parent_instance;
+};
+
+enum {
+    PROP_0,
+    PROP_N_GAUGES,
+    PROP_COLUMNS,
+    PROP_LOWER,
+    PROP_UPPER,
+    PROP_HAND_MODE,
+    NUM_PROPERTIES,
+};
+
+static GParamSpec *props[NUM_PROPERTIES] = { 0 };
+
+
+G_DEFINE_TYPE_WITH_PRIVATE(AgwGaugeGrid, agw_gauge_grid, GTK_TYPE_WIDGET)
+
+
+static gint
+get_columns(AgwGaugeGridPrivate *priv)
+{
+    if (priv->columns > 0) {
+        return priv->columns;
+    }
+
+    /* Roughly square */
+    return MAX(ceil(sqrt(priv->n_gauges)), 1);
+}
+
+static void
+get_layout(AgwGaugeGrid *grid, AgwGaugeGridLayout *layout)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    GtkWidget *widget = GTK_WIDGET(grid);
+
+    layout->columns = get_columns(priv);
+    layout->rows = MAX((priv->n_gauges + layout->columns - 1) / layout->columns, 1);
+    layout->cell_width = gtk_widget_get_allocated_width(widget) / layout->columns;
+    layout->cell_height = gtk_widget_get_allocated_height(widget) / layout->rows;
+    layout->size = MIN(layout->cell_width, layout->cell_height);
+}
+
+/* Where the gauge @n is drawn, in widget coordinates */
+static void
+get_gauge_origin(const AgwGaugeGridLayout *layout, guint n, gint *x, gint *y)
+{
+    *x = (n % layout->columns) * layout->cell_width + (layout->cell_width - layout->size) / 2;
+    *y = (n / layout->columns) * layout->cell_height + (layout->cell_height - layout->size) / 2;
+}
+
+static gdouble
+get_angle(AgwGaugeGrid *grid, guint n)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    gdouble angle;
+    guint steps;
+
+    /* Same mapping as AgwGauge */
+    angle = priv->upper > priv->lower ?
+            priv->values[n] * 2*G_PI / (priv->upper - priv->lower) : 0;
+    angle -= G_PI_2;
+
+    if (agw_gauge_renderer_get_hand_mode(priv->renderer) == AGW_GAUGE_HAND_MODE_ATLAS) {
+        steps = agw_gauge_renderer_get_hand_steps(priv->renderer);
+        angle = lround(angle * steps / (2*G_PI)) * 2*G_PI / steps;
+    }
+
+    return angle;
+}
+
+static gboolean
+get_hand_area(AgwGaugeGrid *grid, const AgwGaugeGridLayout *layout,
+              guint n, gdouble angle, GdkRectangle *area)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    gint x, y;
+
+    if (!agw_gauge_renderer_get_hand_area(priv->renderer, layout->size,
+                                          AGW_GAUGE_HAND_MINUTE, angle, area)) {
+        return FALSE;
+    }
+
+    get_gauge_origin(layout, n, &x, &y);
+    area->x += x;
+    area->y += y;
+    return TRUE;
+}
+
+static void
+queue_full_redraw(AgwGaugeGrid *grid)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+
+    priv->drawn = FALSE;
+    gtk_widget_queue_draw(GTK_WIDGET(grid));
+}
+
+static void
+queue_gauge_redraw(AgwGaugeGrid *grid, const AgwGaugeGridLayout *layout, guint n)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    GdkRectangle old, new;
+    gdouble angle;
+
+    angle = get_angle(grid, n);
+    if (angle == priv->drawn_angles[n]) {
+        return;
+    }
+
+    /* Invalidate the old and the new position of the hand */
+    if (!get_hand_area(grid, layout, n, priv->drawn_angles[n], &old) ||
+        !get_hand_area(grid, layout, n, angle, &new)) {
+        return;
+    }
+    gdk_rectangle_union(&old, &new, &new);
+    gtk_widget_queue_draw_area(GTK_WIDGET(grid), new.x, new.y, new.width, new.height);
+}
+
+static void
+ensure_theme(AgwGaugeGrid *grid)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    AgwGaugeTheme *theme;
+    gint64 begin;
+
+    if (agw_gauge_renderer_peek_theme(priv->renderer) != NULL) {
+        return;
+    }
+
+    begin = agw_perf_begin();
+    theme = agw_gauge_theme_load(AGW_GAUGE_THEME_DEFAULT, NULL);
+    agw_perf_end(AGW_PERF_THEME_LOAD, grid, begin, "AgwGaugeGrid.set_theme");
+
+    if (theme != NULL) {
+        agw_gauge_renderer_take_theme(priv->renderer, theme);
+    }
+}
+
+/* Selects the cells intersecting the area to redraw, in index order */
+static guint
+select_cells(AgwGaugeGrid *grid, const AgwGaugeGridLayout *layout, cairo_t *cr)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    cairo_rectangle_list_t *list;
+    cairo_rectangle_t *rect;
+    gint column, first_column, last_column, row, first_row, last_row, i;
+    guint n, n_cells;
+
+    list = cairo_copy_clip_rectangle_list(cr);
+    if (list->status != CAIRO_STATUS_SUCCESS) {
+        /* Clip not representable by rectangles: draw everything */
+        cairo_rectangle_list_destroy(list);
+        for (n = 0; n < priv->n_gauges; ++n) {
+            priv->cells[n] = n;
+        }
+        return priv->n_gauges;
+    }
+
+    /* A new pass invalidates all the previous marks */
+    if (++priv->pass == 0) {
+        memset(priv->marks, 0, priv->n_gauges * sizeof(guint));
+        priv->pass = 1;
+    }
+
+    n_cells = 0;
+    for (i = 0; i < list->num_rectangles; ++i) {
+        rect = &list->rectangles[i];
+        first_column = MAX(floor(rect->x / layout->cell_width), 0);
+        last_column = MIN(ceil((rect->x + rect->width) / layout->cell_width), layout->columns);
+        first_row = MAX(floor(rect->y / layout->cell_height), 0);
+        last_row = MIN(ceil((rect->y + rect->height) / layout->cell_height), layout->rows);
+        for (row = first_row; row < last_row; ++row) {
+            for (column = first_column; column < last_column; ++column) {
+                n = row * layout->columns + column;
+                if (n < priv->n_gauges && priv->marks[n] != priv->pass) {
+                    priv->marks[n] = priv->pass;
+                    priv->cells[n_cells++] = n;
+                }
+            }
+        }
+    }
+
+    cairo_rectangle_list_destroy(list);
+    return n_cells;
+}
+
+static void
+render(GtkWidget *widget, cairo_t *cr)
+{
+    AgwGaugeGrid *grid = AGW_GAUGE_GRID(widget);
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+    AgwGaugeRenderer *renderer = priv->renderer;
+    AgwGaugeGridLayout layout;
+    guint n, i, n_cells;
+    gint x, y;
+    gdouble angle;
+
+    ensure_theme(grid);
+    if (agw_gauge_renderer_peek_theme(renderer) == NULL || priv->n_gauges == 0) {
+        return;
+    }
+
+    get_layout(grid, &layout);
+    if (layout.size <= 0) {
+        return;
+    }
+
+    /* All the cells share the same size, hence the same layers */
+    n_cells = select_cells(grid, &layout, cr);
+    for (i = 0; i < n_cells; ++i) {
+        n = priv->cells[i];
+        angle = get_angle(grid, n);
+        get_gauge_origin(&layout, n, &x, &y);
+
+        cairo_save(cr);
+        cairo_translate(cr, x, y);
+        agw_gauge_renderer_render_background(renderer, cr, layout.size);
+        agw_gauge_renderer_render_hand(renderer, cr, layout.size, AGW_GAUGE_HAND_MINUTE, angle);
+        agw_gauge_renderer_render_foreground(renderer, cr, layout.size);
+        cairo_restore(cr);
+
+        priv->drawn_angles[n] = angle;
+    }
+
+    /* Cells out of the clip are already showing their drawn angle */
+    priv->drawn = TRUE;
+}
+
+static gboolean
+draw(GtkWidget *widget, cairo_t *cr)
+{
+    gint64 begin = agw_perf_begin();
+
+    render(widget, cr);
+    agw_perf_end(AGW_PERF_DRAW, widget, begin, "AgwGaugeGrid.draw");
+
+    return FALSE;
+}
+
+static void
+get_preferred_width(GtkWidget *widget, gint *minimum, gint *natural)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(AGW_GAUGE_GRID(widget));
+    gint columns = get_columns(priv);
+
+    *minimum = 32 * columns;
+    *natural = 100 * columns;
+}
+
+static void
+get_preferred_height(GtkWidget *widget, gint *minimum, gint *natural)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(AGW_GAUGE_GRID(widget));
+    gint columns = get_columns(priv);
+    gint rows = MAX((priv->n_gauges + columns - 1) / columns, 1);
+
+    *minimum = 32 * rows;
+    *natural = 100 * rows;
+}
+
+static void
+size_allocate(GtkWidget *widget, GtkAllocation *allocation)
+{
+    GtkAllocation old;
+
+    gtk_widget_get_allocation(widget, &old);
+    GTK_WIDGET_CLASS(agw_gauge_grid_parent_class)->size_allocate(widget, allocation);
+
+    /* redraw-on-allocate is disabled, so a full redraw must be queued
+     * explicitly when the geometry really changes */
+    if (old.x != allocation->x || old.y != allocation->y ||
+        old.width != allocation->width || old.height != allocation->height) {
+        queue_full_redraw(AGW_GAUGE_GRID(widget));
+    }
+}
+
+static void
+scale_factor_changed(GtkWidget *widget, GParamSpec *pspec, gpointer user_data)
+{
+    /* The renderer picks up the new scale from the cairo context */
+    queue_full_redraw(AGW_GAUGE_GRID(widget));
+}
+
+static void
+realize(GtkWidget *widget)
+{
+    GTK_WIDGET_CLASS(agw_gauge_grid_parent_class)->realize(widget);
+    ensure_theme(AGW_GAUGE_GRID(widget));
+}
+
+static void
+finalize(GObject *object)
+{
+    AgwGaugeGrid *grid = AGW_GAUGE_GRID(object);
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+
+    g_clear_object(&priv->renderer);
+    g_free(priv->values);
+    g_free(priv->drawn_angles);
+    g_free(priv->marks);
+    g_free(priv->cells);
+
+    G_OBJECT_CLASS(agw_gauge_grid_parent_class)->finalize(object);
+}
+
+static void
+get_property(GObject *object, guint prop_id,
+             GValue *value, GParamSpec *pspec)
+{
+    AgwGaugeGrid *grid = AGW_GAUGE_GRID(object);
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+
+    switch (prop_id) {
+    case PROP_N_GAUGES:
+        g_value_set_uint(value, priv->n_gauges);
+        break;
+    case PROP_COLUMNS:
+        g_value_set_uint(value, priv->columns);
+        break;
+    case PROP_LOWER:
+        g_value_set_double(value, priv->lower);
+        break;
+    case PROP_UPPER:
+        g_value_set_double(value, priv->upper);
+        break;
+    case PROP_HAND_MODE:
+        g_value_set_enum(value, agw_gauge_grid_get_hand_mode(grid));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+set_property(GObject *object, guint prop_id,
+             const GValue *value, GParamSpec *pspec)
+{
+    AgwGaugeGrid *grid = AGW_GAUGE_GRID(object);
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+
+    switch (prop_id) {
+    case PROP_N_GAUGES:
+        agw_gauge_grid_set_n_gauges(grid, g_value_get_uint(value));
+        break;
+    case PROP_COLUMNS:
+        agw_gauge_grid_set_columns(grid, g_value_get_uint(value));
+        break;
+    case PROP_LOWER:
+        agw_gauge_grid_set_range(grid, g_value_get_double(value), priv->upper);
+        break;
+    case PROP_UPPER:
+        agw_gauge_grid_set_range(grid, priv->lower, g_value_get_double(value));
+        break;
+    case PROP_HAND_MODE:
+        agw_gauge_grid_set_hand_mode(grid, g_value_get_enum(value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+agw_gauge_grid_class_init(AgwGaugeGridClass *class)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(class);
+
+    object_class->finalize = finalize;
+    object_class->get_property = get_property;
+    object_class->set_property = set_property;
+
+    widget_class->get_preferred_width = get_preferred_width;
+    widget_class->get_preferred_height = get_preferred_height;
+    widget_class->realize = realize;
+    widget_class->size_allocate = size_allocate;
+    widget_class->draw = draw;
+
+    props[PROP_N_GAUGES] = g_param_spec_uint("n-gauges",
+                                             "Number of Gauges",
+                                             "How many gauges are shown",
+                                             0, G_MAXUINT16, 1,
+                                             G_PARAM_READWRITE);
+    props[PROP_COLUMNS] = g_param_spec_uint("columns",
+                                            "Columns",
+                                            "Number of columns of the grid, 0 to keep it roughly square",
+                                            0, G_MAXUINT16, 0,
+                                            G_PARAM_READWRITE);
+    props[PROP_LOWER] = g_param_spec_double("lower",
+                                            "Lower",
+                                            "Lower limit of all the gauges",
+                                            -G_MAXDOUBLE, G_MAXDOUBLE, 0,
+                                            G_PARAM_READWRITE);
+    props[PROP_UPPER] = g_param_spec_double("upper",
+                                            "Upper",
+                                            "Upper limit of all the gauges",
+                                            -G_MAXDOUBLE, G_MAXDOUBLE, 100,
+                                            G_PARAM_READWRITE);
+    props[PROP_HAND_MODE] = g_param_spec_enum("hand-mode",
+                                              "Hand Mode",
+                                              "How the hands are rendered",
+                                              AGW_TYPE_GAUGE_HAND_MODE,
+                                              AGW_GAUGE_HAND_MODE_VECTOR,
+                                              G_PARAM_READWRITE);
+
+    g_object_class_install_properties(object_class, NUM_PROPERTIES, props);
+}
+
+static void
+agw_gauge_grid_init(AgwGaugeGrid *grid)
+{
+    AgwGaugeGridPrivate *priv = agw_gauge_grid_get_instance_private(grid);
+
+    gtk_widget_set_has_window(GTK_WIDGET(grid), FALSE);
+    gtk_widget_set_redraw_on_allocate(GTK_WIDGET(grid), FALSE);
+    g_signal_connect(grid, "notify::scale-factor",
+                     G_CALLBACK(scale_factor_changed), NULL);
+
+    priv->renderer      = agw_gauge_renderer_new();
+    priv->n_gauges      = 0;
+    priv->columns       = 0;
+    priv->lower         = 0;
+    priv->upper         = 100;
+    priv->values        = NULL;
+    priv->drawn         = FALSE;
+    priv->drawn_angles  = NULL;
+    priv->marks         = NULL;
+    priv->pass          = 0;
+    priv->cells         = NULL;
+
+    agw_gauge_grid_set_n_gauges(grid, 1);
+
+    /* The default theme is loaded lazily by ensure_theme() */
+}
+
+
+/**
+ * agw_gauge_grid_new:
+ * @n_gauges: the number of gauges to show
+ *
+ * Creates a new #AgwGaugeGrid widget.
+ *
+ * Returns: the newly created widget
+ **/
+GtkWidget *
+agw_gauge_grid_new(guint n_gauges)
+{
+    GtkWidget *widget = (GtkWidget *) g_object_new(AGW_TYPE_GAUGE_GRID,
+                                                   "n-gauges", n_gauges,
+                                                   NULL);
+    return widget;
+}
+
+/**
+ * agw_gauge_grid_set_theme:
+ * @grid: an #AgwGaugeGrid
+ * @theme_dir: path to the new theme
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Sets the theme of all the gauges of @grid. See agw_gauge_set_theme()
+ * for details on the themes. If the theme cannot be loaded, the
+ * previous theme is kept.
+ *
+ * @return: TRUE if the theme has been succesfully changed.
+ **/
+gboolean
+agw_gauge_grid_set_theme(AgwGaugeGrid *grid, const gchar *theme_dir, GError **error)
+{
+    AgwGaugeGridPrivate *priv;
+    gint64 begin;
+    gboolean success;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_GRID(grid), FALSE);
+    g_return_val_if_fail(theme_dir != NULL, FALSE);
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    begin = agw_perf_begin();
+    success = agw_gauge_renderer_set_theme(priv->renderer, theme_dir, error);
+    agw_perf_end(AGW_PERF_THEME_LOAD, grid, begin, "AgwGaugeGrid.set_theme");
+
+    if (success) {
+        queue_full_redraw(grid);
+    }
+    return success;
+}
+
+/**
+ * agw_gauge_grid_set_n_gauges:
+ * @grid: an #AgwGaugeGrid
+ * @n_gauges: the new number of gauges
+ *
+ * Changes how many gauges are shown. The values of the gauges that
+ * are kept are preserved, the new ones start at 0.
+ **/
+void
+agw_gauge_grid_set_n_gauges(AgwGaugeGrid *grid, guint n_gauges)
+{
+    AgwGaugeGridPrivate *priv;
+    guint n;
+
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    if (n_gauges == priv->n_gauges) {
+        return;
+    }
+
+    priv->values = g_renew(gdouble, priv->values, n_gauges);
+    priv->drawn_angles = g_renew(gdouble, priv->drawn_angles, n_gauges);
+    for (n = priv->n_gauges; n < n_gauges; ++n) {
+        priv->values[n] = 0;
+        priv->drawn_angles[n] = 0;
+    }
+    g_free(priv->marks);
+    priv->marks = g_new0(guint, n_gauges);
+    priv->pass = 0;
+    priv->cells = g_renew(guint, priv->cells, n_gauges);
+    priv->n_gauges = n_gauges;
+
+    g_object_notify_by_pspec(G_OBJECT(grid), props[PROP_N_GAUGES]);
+    priv->drawn = FALSE;
+    gtk_widget_queue_resize(GTK_WIDGET(grid));
+}
+
+/**
+ * agw_gauge_grid_get_n_gauges:
+ * @grid: an #AgwGaugeGrid
+ *
+ * Gets the number of gauges shown by @grid.
+ *
+ * @return: the number of gauges
+ **/
+guint
+agw_gauge_grid_get_n_gauges(AgwGaugeGrid *grid)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_GRID(grid), 0);
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    return priv->n_gauges;
+}
+
+/**
+ * agw_gauge_grid_set_columns:
+ * @grid: an #AgwGaugeGrid
+ * @columns: the number of columns, or 0
+ *
+ * Sets how many gauges are shown on each row. With 0 (the default) the
+ * number of columns is chosen to have a roughly square grid.
+ **/
+void
+agw_gauge_grid_set_columns(AgwGaugeGrid *grid, guint columns)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    if (columns != priv->columns) {
+        priv->columns = columns;
+        g_object_notify_by_pspec(G_OBJECT(grid), props[PROP_COLUMNS]);
+        priv->drawn = FALSE;
+        gtk_widget_queue_resize(GTK_WIDGET(grid));
+    }
+}
+
+/**
+ * agw_gauge_grid_get_columns:
+ * @grid: an #AgwGaugeGrid
+ *
+ * Gets the number of columns set with agw_gauge_grid_set_columns().
+ *
+ * @return: the number of columns, 0 if automatic
+ **/
+guint
+agw_gauge_grid_get_columns(AgwGaugeGrid *grid)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_GRID(grid), 0);
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    return priv->columns;
+}
+
+/**
+ * agw_gauge_grid_set_range:
+ * @grid: an #AgwGaugeGrid
+ * @lower: the lower limit
+ * @upper: the upper limit
+ *
+ * Sets the limits shared by all the gauges: as for #AgwGauge, a whole
+ * turn of the hand spans from @lower to @upper.
+ **/
+void
+agw_gauge_grid_set_range(AgwGaugeGrid *grid, gdouble lower, gdouble upper)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    if (lower == priv->lower && upper == priv->upper) {
+        return;
+    }
+
+    g_object_freeze_notify(G_OBJECT(grid));
+    if (lower != priv->lower) {
+        priv->lower = lower;
+        g_object_notify_by_pspec(G_OBJECT(grid), props[PROP_LOWER]);
+    }
+    if (upper != priv->upper) {
+        priv->upper = upper;
+        g_object_notify_by_pspec(G_OBJECT(grid), props[PROP_UPPER]);
+    }
+    g_object_thaw_notify(G_OBJECT(grid));
+
+    queue_full_redraw(grid);
+}
+
+/**
+ * agw_gauge_grid_get_range:
+ * @grid: an #AgwGaugeGrid
+ * @lower: (out) (optional): where to store the lower limit
+ * @upper: (out) (optional): where to store the upper limit
+ *
+ * Gets the limits shared by all the gauges.
+ **/
+void
+agw_gauge_grid_get_range(AgwGaugeGrid *grid, gdouble *lower, gdouble *upper)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    if (lower != NULL) {
+        *lower = priv->lower;
+    }
+    if (upper != NULL) {
+        *upper = priv->upper;
+    }
+}
+
+/**
+ * agw_gauge_grid_set_hand_mode:
+ * @grid: an #AgwGaugeGrid
+ * @mode: the new hand mode
+ *
+ * Sets how the hands are rendered: see agw_gauge_set_hand_mode().
+ * As all the gauges share the same renderer, the bitmap and atlas
+ * modes are rasterized once for the whole grid.
+ **/
+void
+agw_gauge_grid_set_hand_mode(AgwGaugeGrid *grid, AgwGaugeHandMode mode)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    if (mode != agw_gauge_renderer_get_hand_mode(priv->renderer)) {
+        agw_gauge_renderer_set_hand_mode(priv->renderer, mode);
+        g_object_notify_by_pspec(G_OBJECT(grid), props[PROP_HAND_MODE]);
+        queue_full_redraw(grid);
+    }
+}
+
+/**
+ * agw_gauge_grid_get_hand_mode:
+ * @grid: an #AgwGaugeGrid
+ *
+ * Gets how the hands are rendered.
+ *
+ * @return: the current hand mode
+ **/
+AgwGaugeHandMode
+agw_gauge_grid_get_hand_mode(AgwGaugeGrid *grid)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_GRID(grid), AGW_GAUGE_HAND_MODE_VECTOR);
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    return agw_gauge_renderer_get_hand_mode(priv->renderer);
+}
+
+/**
+ * agw_gauge_grid_set_value:
+ * @grid: an #AgwGaugeGrid
+ * @index: the gauge to change, starting from 0
+ * @value: the new value
+ *
+ * Sets the value of a single gauge. Only the area swept by its hand
+ * is invalidated.
+ **/
+void
+agw_gauge_grid_set_value(AgwGaugeGrid *grid, guint index, gdouble value)
+{
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+
+    agw_gauge_grid_set_values(grid, index, &value, 1);
+}
+
+/**
+ * agw_gauge_grid_get_value:
+ * @grid: an #AgwGaugeGrid
+ * @index: the gauge to query, starting from 0
+ *
+ * Gets the value of a single gauge.
+ *
+ * @return: the value of the gauge
+ **/
+gdouble
+agw_gauge_grid_get_value(AgwGaugeGrid *grid, guint index)
+{
+    AgwGaugeGridPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_GRID(grid), 0);
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    g_return_val_if_fail(index < priv->n_gauges, 0);
+
+    return priv->values[index];
+}
+
+/**
+ * agw_gauge_grid_set_values:
+ * @grid: an #AgwGaugeGrid
+ * @first: index of the first gauge to change
+ * @values: (array length=n_values): the new values
+ * @n_values: number of elements in @values
+ *
+ * Sets the values of the gauges from @first to `first + n_values - 1`
+ * in one go. No signal is emitted and only the hands that actually
+ * moved are invalidated, so this is the way to go when refreshing the
+ * whole grid at every frame.
+ **/
+void
+agw_gauge_grid_set_values(AgwGaugeGrid *grid, guint first,
+                          const gdouble *values, guint n_values)
+{
+    AgwGaugeGridPrivate *priv;
+    AgwGaugeGridLayout layout;
+    guint n;
+
+    g_return_if_fail(AGW_IS_GAUGE_GRID(grid));
+    g_return_if_fail(values != NULL || n_values == 0);
+
+    priv = agw_gauge_grid_get_instance_private(grid);
+    g_return_if_fail(first <= priv->n_gauges && n_values <= priv->n_gauges - first);
+
+    if (n_values == 0) {
+        return;
+    }
+
+    agw_perf_count(AGW_PERF_REDRAW, grid);
+
+    if (!priv->drawn) {
+        /* A full redraw is already pending */
+        memcpy(priv->values + first, values, n_values * sizeof(gdouble));
+        gtk_widget_queue_draw(GTK_WIDGET(grid));
+        return;
+    }
+
+    get_layout(grid, &layout);
+    for (n = 0; n < n_values; ++n) {
+        if (values[n] != priv->values[first + n]) {
+            priv->values[first + n] = values[n];
+            queue_gauge_redraw(grid, &layout, first + n);
+        }
+    }
+}
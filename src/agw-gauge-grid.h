@@ -0,0 +1,66 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __AGW_GAUGE_GRID_H__
+#define __AGW_GAUGE_GRID_H__
+
+#include <gtk/gtk.h>
+#include "agw-gauge-renderer.h"
+
+
+G_BEGIN_DECLS
+
+#define AGW_TYPE_GAUGE_GRID agw_gauge_grid_get_type()
+
+G_DECLARE_FINAL_TYPE(AgwGaugeGrid, agw_gauge_grid, AGW, GAUGE_GRID, GtkWidget)
+
+
+GtkWidget *     agw_gauge_grid_new          (guint              n_gauges);
+gboolean        agw_gauge_grid_set_theme    (AgwGaugeGrid *     grid,
+                                             const gchar *      theme_dir,
+                                             GError **          error);
+void            agw_gauge_grid_set_n_gauges (AgwGaugeGrid *     grid,
+                                             guint              n_gauges);
+guint           agw_gauge_grid_get_n_gauges (AgwGaugeGrid *     grid);
+void            agw_gauge_grid_set_columns  (AgwGaugeGrid *     grid,
+                                             guint              columns);
+guint           agw_gauge_grid_get_columns  (AgwGaugeGrid *     grid);
+void            agw_gauge_grid_set_range    (AgwGaugeGrid *     grid,
+                                             gdouble            lower,
+                                             gdouble            upper);
+void            agw_gauge_grid_get_range    (AgwGaugeGrid *     grid,
+                                             gdouble *          lower,
+                                             gdouble *          upper);
+void            agw_gauge_grid_set_hand_mode(AgwGaugeGrid *     grid,
+                                             AgwGaugeHandMode   mode);
+AgwGaugeHandMode
+                agw_gauge_grid_get_hand_mode(AgwGaugeGrid *     grid);
+void            agw_gauge_grid_set_value    (AgwGaugeGrid *     grid,
+                                             guint              index,
+                                             gdouble            value);
+gdouble         agw_gauge_grid_get_value    (AgwGaugeGrid *     grid,
+                                             guint              index);
+void            agw_gauge_grid_set_values   (AgwGaugeGrid *     grid,
+                                             guint              first,
+                                             const gdouble *    values,
+                                             guint              n_values);
+
+G_END_DECLS
+
+
+#endif /* __AGW_GAUGE_GRID_H__ */
@@ -0,0 +1,536 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Theme packs: a whole theme compiled into a single file.
+ *
+ * A pack holds the static layers and the hand sprites of a theme
+ * already rasterized at a set of sizes and scale factors, in the
+ * premultiplied format used by cairo, so they can be painted straight
+ * from the memory mapped file. The SVG sources of every element are
+ * stored too, as vector fallback for the sizes not included and for
+ * the hand modes that need the vector data.
+ *
+ * The layout is: the header, the image table, the SVG sources and the
+ * pixel data, each image aligned to AGW_GAUGE_PACK_ALIGNMENT bytes.
+ * Everything is in native byte order: packs are generated by the
+ * agw-theme-compile tool on (or for) the target machine.
+ */
+
+#include "agw-gauge-pack.h"
+#include <gio/gio.h>
+#include <math.h>
+#include <string.h>
+
+
+static const cairo_user_data_key_t mapping_key;
+
+
+static gboolean
+blob_is_valid(const AgwGaugePackBlob *blob, gsize length)
+{
+    return blob->offset <= length && blob->length <= length - blob->offset;
+}
+
+static gboolean
+ink_is_valid(const AgwGaugePackHeader *header)
+{
+    guint i, j;
+
+    /* x and y are offsets from the pivot, so only the extents must
+     * be positive */
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        for (j = 0; j < 4; ++j) {
+            if (!isfinite(header->ink[i][j])) {
+                return FALSE;
+            }
+        }
+        if (header->ink[i][2] < 0 || header->ink[i][3] < 0) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static gboolean
+image_is_valid(const AgwGaugePackImage *image, gsize length)
+{
+    if (image->kind > AGW_GAUGE_PACK_SPRITE ||
+        image->element >= AGW_GAUGE_ELEMENT_LAST ||
+        image->size <= 0 || image->scale <= 0 ||
+        image->width <= 0 || image->height <= 0) {
+        return FALSE;
+    }
+
+    /* cairo requires 32 bit aligned pixel rows */
+    if (image->stride < cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, image->width) ||
+        image->stride % 4 != 0 || image->offset % 4 != 0) {
+        return FALSE;
+    }
+
+    return image->offset <= length &&
+           (guint64) image->stride * image->height <= length - image->offset;
+}
+
+static gboolean
+pack_is_valid(const gchar *data, gsize length, const gchar *filename, GError **error)
+{
+    const AgwGaugePackHeader *header = (const AgwGaugePackHeader *) data;
+    const AgwGaugePackImage *images;
+    guint i;
+
+    if (length < sizeof(AgwGaugePackHeader) ||
+        memcmp(header->magic, AGW_GAUGE_PACK_MAGIC, sizeof(header->magic)) != 0) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                    "'%s' is not a theme pack", filename);
+        return FALSE;
+    }
+
+    if (header->byte_order != AGW_GAUGE_PACK_BYTE_ORDER ||
+        header->version != AGW_GAUGE_PACK_VERSION) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                    "The theme pack '%s' has been compiled for a different "
+                    "architecture or library version", filename);
+        return FALSE;
+    }
+
+    if (header->width <= 0 || header->height <= 0 ||
+        !ink_is_valid(header) ||
+        header->n_images > (length - sizeof(AgwGaugePackHeader)) / sizeof(AgwGaugePackImage)) {
+        goto invalid;
+    }
+
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        if (!blob_is_valid(&header->svg[i], length)) {
+            goto invalid;
+        }
+    }
+
+    images = (const AgwGaugePackImage *) (header + 1);
+    for (i = 0; i < header->n_images; ++i) {
+        if (!image_is_valid(&images[i], length)) {
+            goto invalid;
+        }
+    }
+
+    return TRUE;
+
+invalid:
+    g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                "The theme pack '%s' is corrupted", filename);
+    return FALSE;
+}
+
+static void
+add_image(GArray *images, AgwGaugePackKind kind, AgwGaugeElement element,
+          gint size, gint scale, const cairo_rectangle_int_t *area)
+{
+    AgwGaugePackImage image;
+
+    memset(&image, 0, sizeof(image));
+    image.kind    = kind;
+    image.element = element;
+    image.size    = size;
+    image.scale   = scale;
+    image.x       = area->x;
+    image.y       = area->y;
+    image.width   = area->width * scale;
+    image.height  = area->height * scale;
+    image.stride  = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, image.width);
+
+    g_array_append_val(images, image);
+}
+
+/* Writes the pixels of @surface, that must match the planned @image */
+static gboolean
+write_image(GOutputStream *stream, const AgwGaugePackImage *image,
+            cairo_surface_t *surface, GError **error)
+{
+    gboolean success;
+
+    cairo_surface_flush(surface);
+    if (cairo_image_surface_get_width(surface) != image->width ||
+        cairo_image_surface_get_height(surface) != image->height ||
+        cairo_image_surface_get_stride(surface) != image->stride) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                    "Unexpected size of a rasterized image");
+        success = FALSE;
+    } else {
+        success = g_output_stream_write_all(stream, cairo_image_surface_get_data(surface),
+                                            (gsize) image->stride * image->height,
+                                            NULL, NULL, error);
+    }
+
+    cairo_surface_destroy(surface);
+    return success;
+}
+
+static gboolean
+write_padding(GOutputStream *stream, guint64 *offset, guint64 target, GError **error)
+{
+    static const gchar zeros[AGW_GAUGE_PACK_ALIGNMENT] = { 0 };
+    gsize length = target - *offset;
+
+    *offset = target;
+    return length == 0 ||
+           g_output_stream_write_all(stream, zeros, length, NULL, NULL, error);
+}
+
+/*
+ * agw_gauge_pack_open:
+ * @filename: path to the theme pack
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Maps @filename in memory and validates its content, so the data
+ * returned by the other agw_gauge_pack_*() functions can be trusted.
+ *
+ * Returns: the pack, to be freed with agw_gauge_pack_free(), or %NULL
+ *          on errors
+ */
+AgwGaugePack *
+agw_gauge_pack_open(const gchar *filename, GError **error)
+{
+    AgwGaugePack *pack;
+    GMappedFile *file;
+    const gchar *data;
+    gsize length;
+
+    file = g_mapped_file_new(filename, FALSE, error);
+    if (file == NULL) {
+        return NULL;
+    }
+
+    data = g_mapped_file_get_contents(file);
+    length = g_mapped_file_get_length(file);
+    if (!pack_is_valid(data, length, filename, error)) {
+        g_mapped_file_unref(file);
+        return NULL;
+    }
+
+    pack = g_new0(AgwGaugePack, 1);
+    pack->file   = file;
+    pack->header = (const AgwGaugePackHeader *) data;
+    pack->images = (const AgwGaugePackImage *) (pack->header + 1);
+
+    return pack;
+}
+
+void
+agw_gauge_pack_free(AgwGaugePack *pack)
+{
+    if (pack != NULL) {
+        g_mapped_file_unref(pack->file);
+        g_free(pack);
+    }
+}
+
+/*
+ * agw_gauge_pack_get_svg:
+ * @pack: an #AgwGaugePack
+ * @element: an #AgwGaugeElement
+ *
+ * Gets the SVG source of @element, without copying it.
+ *
+ * Returns: (transfer full): the source or %NULL if @pack does not
+ *          contain @element
+ */
+GBytes *
+agw_gauge_pack_get_svg(AgwGaugePack *pack, AgwGaugeElement element)
+{
+    const AgwGaugePackBlob *blob = &pack->header->svg[element];
+    const gchar *data;
+
+    if (blob->length == 0) {
+        return NULL;
+    }
+
+    data = g_mapped_file_get_contents(pack->file);
+    return g_bytes_new_with_free_func(data + blob->offset, blob->length,
+                                      (GDestroyNotify) g_mapped_file_unref,
+                                      g_mapped_file_ref(pack->file));
+}
+
+/*
+ * agw_gauge_pack_get_image:
+ * @pack: an #AgwGaugePack
+ * @kind: the kind of image to look for
+ * @element: the element of a %AGW_GAUGE_PACK_SPRITE, ignored otherwise
+ * @size: size of the gauge, in logical pixels
+ * @scale: scale factor of the target device
+ * @x: (out) (optional): where to store the x offset of a sprite
+ * @y: (out) (optional): where to store the y offset of a sprite
+ *
+ * Looks for a pre-rasterized image in @pack. The returned surface
+ * points directly to the mapped file, that is kept alive until the
+ * surface is destroyed.
+ *
+ * Returns: (transfer full): the image or %NULL if not included in @pack
+ */
+cairo_surface_t *
+agw_gauge_pack_get_image(AgwGaugePack *pack, AgwGaugePackKind kind,
+                         AgwGaugeElement element, gint size, gint scale,
+                         gint *x, gint *y)
+{
+    const AgwGaugePackImage *image;
+    cairo_surface_t *surface;
+    gchar *data;
+    guint i;
+
+    if (kind != AGW_GAUGE_PACK_SPRITE) {
+        element = 0;
+    }
+
+    for (i = 0; i < pack->header->n_images; ++i) {
+        image = &pack->images[i];
+        if (image->kind == (guint32) kind && image->element == (guint32) element &&
+            image->size == size && image->scale == scale) {
+            break;
+        }
+    }
+    if (i == pack->header->n_images) {
+        return NULL;
+    }
+
+    /* The mapping is read-only, but these surfaces are only used as
+     * sources so cairo never writes to them */
+    data = g_mapped_file_get_contents(pack->file) + image->offset;
+    surface = cairo_image_surface_create_for_data((guchar *) data, CAIRO_FORMAT_ARGB32,
+                                                  image->width, image->height,
+                                                  image->stride);
+    cairo_surface_set_device_scale(surface, scale, scale);
+    cairo_surface_set_user_data(surface, &mapping_key,
+                                g_mapped_file_ref(pack->file),
+                                (cairo_destroy_func_t) g_mapped_file_unref);
+
+    if (x != NULL) {
+        *x = image->x;
+    }
+    if (y != NULL) {
+        *y = image->y;
+    }
+    return surface;
+}
+
+/*
+ * agw_gauge_pack_write:
+ * @theme: the theme to compile
+ * @sizes: (array length=n_sizes): the sizes to rasterize
+ * @n_sizes: number of elements in @sizes
+ * @scales: (array length=n_scales): the scale factors to rasterize
+ * @n_scales: number of elements in @scales
+ * @filename: where to save the pack
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Compiles @theme into a theme pack containing the static layers and
+ * the bitmap sprites of every hand for every combination of @sizes and
+ * @scales, plus the SVG sources of all the elements.
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+agw_gauge_pack_write(AgwGaugeTheme *theme,
+                     const gint *sizes, guint n_sizes,
+                     const gint *scales, guint n_scales,
+                     const gchar *filename, GError **error)
+{
+    AgwGaugePackHeader header;
+    AgwGaugePackImage *image;
+    AgwGaugeLayers *layers;
+    GBytes *svg[AGW_GAUGE_ELEMENT_LAST] = { NULL };
+    gboolean hand[AGW_GAUGE_THEME_HANDS];
+    cairo_rectangle_int_t area;
+    GArray *images;
+    GFile *file;
+    GFileOutputStream *file_stream;
+    GOutputStream *stream;
+    GCancellable *cancellable;
+    cairo_surface_t *surface;
+    AgwGaugeElement element;
+    guint64 offset;
+    gboolean success;
+    guint i, j, k, n;
+    gint x, y;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, AGW_GAUGE_PACK_MAGIC, sizeof(header.magic));
+    header.version    = AGW_GAUGE_PACK_VERSION;
+    header.byte_order = AGW_GAUGE_PACK_BYTE_ORDER;
+    header.width      = theme->width;
+    header.height     = theme->height;
+
+    images = g_array_new(FALSE, FALSE, sizeof(AgwGaugePackImage));
+    file = NULL;
+    file_stream = NULL;
+    success = FALSE;
+
+    /* Missing hands are allowed, as in any theme */
+    for (n = 0; n < AGW_GAUGE_THEME_HANDS; ++n) {
+        hand[n] = agw_gauge_theme_load_hand(theme, n);
+    }
+
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        header.ink[i][0] = theme->ink[i].x;
+        header.ink[i][1] = theme->ink[i].y;
+        header.ink[i][2] = theme->ink[i].width;
+        header.ink[i][3] = theme->ink[i].height;
+
+        /* Shadows and hands are in the same order */
+        if (i >= AGW_GAUGE_ELEMENT_HOUR_HAND_SHADOW && i <= AGW_GAUGE_ELEMENT_SECOND_HAND &&
+            !hand[(i - AGW_GAUGE_ELEMENT_HOUR_HAND_SHADOW) % AGW_GAUGE_THEME_HANDS]) {
+            continue;
+        }
+
+        svg[i] = agw_gauge_theme_get_svg(theme, i, error);
+        if (svg[i] == NULL) {
+            goto out;
+        }
+    }
+
+    /* Plan the image table, in the same order the images are written
+     * below, without rasterizing anything */
+    for (i = 0; i < n_scales; ++i) {
+        for (j = 0; j < n_sizes; ++j) {
+            area.x = area.y = 0;
+            area.width = area.height = sizes[j];
+            add_image(images, AGW_GAUGE_PACK_BACKGROUND, 0, sizes[j], scales[i], &area);
+            add_image(images, AGW_GAUGE_PACK_FOREGROUND, 0, sizes[j], scales[i], &area);
+
+            for (n = 0; n < AGW_GAUGE_THEME_HANDS; ++n) {
+                if (!hand[n]) {
+                    continue;
+                }
+                element = AGW_GAUGE_ELEMENT_HAND_SHADOW(n);
+                agw_gauge_theme_get_sprite_area(theme, element, sizes[j], &area);
+                add_image(images, AGW_GAUGE_PACK_SPRITE, element, sizes[j], scales[i], &area);
+                element = AGW_GAUGE_ELEMENT_HAND(n);
+                agw_gauge_theme_get_sprite_area(theme, element, sizes[j], &area);
+                add_image(images, AGW_GAUGE_PACK_SPRITE, element, sizes[j], scales[i], &area);
+            }
+        }
+    }
+    header.n_images = images->len;
+
+    /* Lay out the SVG sources and the pixel data after the tables and
+     * fail before doing any work if the result would be too big */
+    offset = sizeof(header) + images->len * sizeof(AgwGaugePackImage);
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        if (svg[i] != NULL) {
+            header.svg[i].offset = offset;
+            header.svg[i].length = g_bytes_get_size(svg[i]);
+            offset += header.svg[i].length;
+        }
+    }
+    for (i = 0; i < images->len; ++i) {
+        image = &g_array_index(images, AgwGaugePackImage, i);
+        offset = (offset + AGW_GAUGE_PACK_ALIGNMENT - 1) / AGW_GAUGE_PACK_ALIGNMENT * AGW_GAUGE_PACK_ALIGNMENT;
+        if (offset > G_MAXUINT32) {
+            break;
+        }
+        image->offset = offset;
+        offset += (guint64) image->stride * image->height;
+    }
+    if (offset > G_MAXUINT32) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                    "The theme pack would be larger than 4 GiB: use fewer sizes");
+        goto out;
+    }
+
+    /* The file is replaced only when everything has been written */
+    file = g_file_new_for_path(filename);
+    file_stream = g_file_replace(file, NULL, FALSE, G_FILE_CREATE_NONE, NULL, error);
+    if (file_stream == NULL) {
+        goto out;
+    }
+    stream = G_OUTPUT_STREAM(file_stream);
+
+    if (!g_output_stream_write_all(stream, &header, sizeof(header), NULL, NULL, error) ||
+        !g_output_stream_write_all(stream, images->data,
+                                   images->len * sizeof(AgwGaugePackImage),
+                                   NULL, NULL, error)) {
+        goto out;
+    }
+    offset = sizeof(header) + images->len * sizeof(AgwGaugePackImage);
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        if (svg[i] == NULL) {
+            continue;
+        }
+        if (!g_output_stream_write_all(stream, g_bytes_get_data(svg[i], NULL),
+                                       header.svg[i].length, NULL, NULL, error)) {
+            goto out;
+        }
+        offset += header.svg[i].length;
+    }
+
+    /* Rasterize and write one image at a time, in the planned order */
+    k = 0;
+    for (i = 0; i < n_scales; ++i) {
+        for (j = 0; j < n_sizes; ++j) {
+            layers = agw_gauge_theme_get_layers(theme, sizes[j], scales[i]);
+            for (n = 0; n < 2; ++n) {
+                image = &g_array_index(images, AgwGaugePackImage, k++);
+                surface = n == 0 ? layers->background : layers->foreground;
+                if (!write_padding(stream, &offset, image->offset, error) ||
+                    !write_image(stream, image, cairo_surface_reference(surface), error)) {
+                    agw_gauge_layers_unref(layers);
+                    goto out;
+                }
+                offset += (guint64) image->stride * image->height;
+            }
+            agw_gauge_layers_unref(layers);
+
+            for (n = 0; n < AGW_GAUGE_THEME_HANDS * 2; ++n) {
+                if (!hand[n / 2]) {
+                    continue;
+                }
+                image = &g_array_index(images, AgwGaugePackImage, k++);
+                surface = agw_gauge_theme_get_sprite(theme, image->element,
+                                                     sizes[j], scales[i], &x, &y);
+                if (!write_padding(stream, &offset, image->offset, error) ||
+                    !write_image(stream, image, surface, error)) {
+                    goto out;
+                }
+                offset += (guint64) image->stride * image->height;
+            }
+        }
+    }
+
+    success = g_output_stream_close(stream, NULL, error);
+
+out:
+    if (file_stream != NULL) {
+        if (!success) {
+            /* Closing a cancelled stream leaves the old file untouched */
+            cancellable = g_cancellable_new();
+            g_cancellable_cancel(cancellable);
+            g_output_stream_close(G_OUTPUT_STREAM(file_stream), cancellable, NULL);
+            g_object_unref(cancellable);
+        }
+        g_object_unref(file_stream);
+    }
+    if (file != NULL) {
+        g_object_unref(file);
+    }
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        if (svg[i] != NULL) {
+            g_bytes_unref(svg[i]);
+        }
+    }
+    g_array_free(images, TRUE);
+    return success;
+}
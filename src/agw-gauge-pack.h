@@ -0,0 +1,122 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Private header: not installed and not part of the public API */
+
+#ifndef __AGW_GAUGE_PACK_H__
+#define __AGW_GAUGE_PACK_H__
+
+#include <glib.h>
+#include <cairo.h>
+#include "agw-gauge-theme.h"
+
+
+G_BEGIN_DECLS
+
+#define AGW_GAUGE_PACK_MAGIC        "AGWPACK"
+#define AGW_GAUGE_PACK_VERSION      1
+/* Written in native order: a pack is only valid on machines with the
+ * same byte order, as the pixel data is in cairo native format */
+#define AGW_GAUGE_PACK_BYTE_ORDER   0x01020304
+/* Alignment of the pixel data inside the pack */
+#define AGW_GAUGE_PACK_ALIGNMENT    64
+
+typedef enum {
+    AGW_GAUGE_PACK_BACKGROUND,
+    AGW_GAUGE_PACK_FOREGROUND,
+    AGW_GAUGE_PACK_SPRITE,
+} AgwGaugePackKind;
+
+typedef struct _AgwGaugePackHeader AgwGaugePackHeader;
+typedef struct _AgwGaugePackBlob AgwGaugePackBlob;
+typedef struct _AgwGaugePackImage AgwGaugePackImage;
+
+/* A chunk of the pack, as offset (from the start of the file) and length */
+struct _AgwGaugePackBlob {
+    guint32             offset;
+    guint32             length;
+};
+
+/* The pack starts with this header, immediately followed by the
+ * n_images entries of the image table */
+struct _AgwGaugePackHeader {
+    gchar               magic[8];
+    guint32             version;
+    guint32             byte_order;
+    gint32              width;
+    gint32              height;
+    /* Ink extents of the elements, as in AgwGaugeTheme */
+    gdouble             ink[AGW_GAUGE_ELEMENT_LAST][4];
+    /* Sources of the elements, for the vector fallback: the length is
+     * 0 for missing hands */
+    AgwGaugePackBlob    svg[AGW_GAUGE_ELEMENT_LAST];
+    guint32             n_images;
+    guint32             reserved;
+};
+
+/* A rasterized layer or hand sprite, stored as premultiplied
+ * CAIRO_FORMAT_ARGB32 pixels */
+struct _AgwGaugePackImage {
+    guint32             kind;
+    /* The element of a AGW_GAUGE_PACK_SPRITE, 0 otherwise */
+    guint32             element;
+    gint32              size;
+    gint32              scale;
+    /* Offset of a sprite from the pivot, in logical pixels */
+    gint32              x;
+    gint32              y;
+    /* In device pixels */
+    gint32              width;
+    gint32              height;
+    gint32              stride;
+    guint32             offset;
+};
+
+/* A pack mapped in memory */
+struct _AgwGaugePack {
+    GMappedFile *               file;
+    const AgwGaugePackHeader *  header;
+    const AgwGaugePackImage *   images;
+};
+
+
+AgwGaugePack *  agw_gauge_pack_open         (const gchar *      filename,
+                                             GError **          error);
+void            agw_gauge_pack_free         (AgwGaugePack *     pack);
+GBytes *        agw_gauge_pack_get_svg      (AgwGaugePack *     pack,
+                                             AgwGaugeElement    element);
+cairo_surface_t *
+                agw_gauge_pack_get_image    (AgwGaugePack *     pack,
+                                             AgwGaugePackKind   kind,
+                                             AgwGaugeElement    element,
+                                             gint               size,
+                                             gint               scale,
+                                             gint *             x,
+                                             gint *             y);
+gboolean        agw_gauge_pack_write        (AgwGaugeTheme *    theme,
+                                             const gint *       sizes,
+                                             guint              n_sizes,
+                                             const gint *       scales,
+                                             guint              n_scales,
+                                             const gchar *      filename,
+                                             GError **          error);
+
+G_END_DECLS
+
+
+#endif /* __AGW_GAUGE_PACK_H__ */
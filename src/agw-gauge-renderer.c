@@ -0,0 +1,869 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * SECTION:agw-gauge-renderer
+ * @short_description: Draws gauges on any cairo context
+ *
+ * #AgwGaugeRenderer contains the drawing logic of #AgwGauge without any
+ * GTK dependency: given a theme, a size and the angles of the hands,
+ * it draws the gauge on any `cairo_t`. It can be used to generate
+ * images offscreen, e.g. for reports or remote status pages.
+ *
+ * A renderer is thread safe: the same instance can be used by several
+ * threads at once. The static layers and the hand sprites are cached
+ * for the last size and scale factor used, so better performances are
+ * achieved by using one renderer per size. The vector rendering of the
+ * SVG elements is serialized across threads, so when many frames are
+ * rendered in parallel the %AGW_GAUGE_HAND_MODE_BITMAP and
+ * %AGW_GAUGE_HAND_MODE_ATLAS modes scale much better.
+ *
+ * The scale factor is taken from the device scale of the target
+ * surface of the cairo context.
+ **/
+
+/**
+ * AgwGaugeRenderer:
+ *
+ * All fields are private and should not be used directly.
+ * Use its public methods instead.
+ **/
+
+#include "agw-gauge-renderer.h"
+#include "agw-gauge-theme.h"
+#include "agw-perf.h"
+#include <math.h>
+
+
+typedef struct {
+    cairo_surface_t *   surface;
+    gint                x;
+    gint                y;
+} AgwGaugeSprite;
+
+typedef struct {
+    AgwGaugeSprite      sprite[2];
+    AgwGaugeSprite *    atlas;
+} AgwGaugeRendererHand;
+
+typedef struct {
+    /* Protects all the fields below */
+    GMutex              mutex;
+
+    AgwGaugeTheme *     theme;
+    AgwGaugeHandMode    hand_mode;
+    guint               hand_steps;
+
+    /* Layers and sprites rasterized at the last size and scale used */
+    gint                size;
+    gint                scale;
+    AgwGaugeLayers *    layers;
+    AgwGaugeRendererHand hand[AGW_GAUGE_THEME_HANDS];
+} AgwGaugeRendererPrivate;
+
+struct _AgwGaugeRenderer {
+    GObject parent_instance;
+};
+
+enum {
+    PROP_0,
+    PROP_HAND_MODE,
+    PROP_HAND_STEPS,
+    NUM_PROPERTIES,
+};
+
+static GParamSpec *props[NUM_PROPERTIES] = { 0 };
+
+
+G_DEFINE_TYPE_WITH_PRIVATE(AgwGaugeRenderer, agw_gauge_renderer, G_TYPE_OBJECT)
+
+
+static void
+sprite_free(AgwGaugeSprite *sprite)
+{
+    if (sprite->surface != NULL) {
+        cairo_surface_destroy(sprite->surface);
+        sprite->surface = NULL;
+    }
+}
+
+static void
+free_sprites(AgwGaugeRendererPrivate *priv)
+{
+    AgwGaugeRendererHand *hand;
+    guint n, i;
+
+    for (n = 0; n < AGW_GAUGE_THEME_HANDS; ++n) {
+        hand = &priv->hand[n];
+        sprite_free(&hand->sprite[0]);
+        sprite_free(&hand->sprite[1]);
+        if (hand->atlas != NULL) {
+            for (i = 0; i < priv->hand_steps; ++i) {
+                sprite_free(&hand->atlas[i]);
+            }
+            g_free(hand->atlas);
+            hand->atlas = NULL;
+        }
+    }
+}
+
+static void
+free_cache(AgwGaugeRendererPrivate *priv)
+{
+    if (priv->layers != NULL) {
+        agw_gauge_layers_unref(priv->layers);
+        priv->layers = NULL;
+    }
+    free_sprites(priv);
+}
+
+static void
+use_size(AgwGaugeRendererPrivate *priv, gint size, gint scale)
+{
+    /* Must be called with the mutex held */
+    if (size != priv->size || scale != priv->scale) {
+        free_cache(priv);
+        priv->size  = size;
+        priv->scale = scale;
+    }
+}
+
+static gint
+get_scale(cairo_t *cr)
+{
+    gdouble x_scale, y_scale;
+
+    cairo_surface_get_device_scale(cairo_get_target(cr), &x_scale, &y_scale);
+    return MAX(1, (gint) ceil(MAX(x_scale, y_scale)));
+}
+
+static void
+extend_extents(gdouble extents[4], const cairo_rectangle_t *ink,
+               gdouble angle, gdouble dx, gdouble dy)
+{
+    gdouble c = cos(angle);
+    gdouble s = sin(angle);
+    gdouble x, y;
+    gint i;
+
+    for (i = 0; i < 4; ++i) {
+        x = ink->x + (i & 1 ? ink->width : 0);
+        y = ink->y + (i & 2 ? ink->height : 0);
+        extents[0] = MIN(extents[0], x * c - y * s + dx);
+        extents[1] = MIN(extents[1], x * s + y * c + dy);
+        extents[2] = MAX(extents[2], x * c - y * s + dx);
+        extents[3] = MAX(extents[3], x * s + y * c + dy);
+    }
+}
+
+static void
+get_hand_extents(AgwGaugeTheme *theme, AgwGaugeHand hand,
+                 gdouble angle, gdouble extents[4])
+{
+    extents[0] = extents[1] = G_MAXDOUBLE;
+    extents[2] = extents[3] = -G_MAXDOUBLE;
+    extend_extents(extents, &theme->ink[AGW_GAUGE_ELEMENT_HAND_SHADOW(hand)],
+                   angle, -0.75, 0.75);
+    extend_extents(extents, &theme->ink[AGW_GAUGE_ELEMENT_HAND(hand)],
+                   angle, 0, 0);
+}
+
+static void
+render_hand(AgwGaugeTheme *theme, cairo_t *cr, AgwGaugeHand hand, gdouble angle)
+{
+    /* `cr` must be in theme units with the origin on the pivot */
+    cairo_save(cr);
+    cairo_translate(cr, -0.75, 0.75);
+    cairo_rotate(cr, angle);
+    agw_gauge_theme_render(theme, AGW_GAUGE_ELEMENT_HAND_SHADOW(hand), cr);
+    cairo_restore(cr);
+    cairo_save(cr);
+    cairo_rotate(cr, angle);
+    agw_gauge_theme_render(theme, AGW_GAUGE_ELEMENT_HAND(hand), cr);
+    cairo_restore(cr);
+}
+
+static cairo_t *
+sprite_init(AgwGaugeRendererPrivate *priv, AgwGaugeSprite *sprite,
+            gdouble pivot, const gdouble extents[4])
+{
+    gdouble sx = (gdouble) priv->size / priv->theme->width;
+    gdouble sy = (gdouble) priv->size / priv->theme->height;
+    gint x2, y2;
+    cairo_t *cr;
+
+    /* Convert the extents (in theme units, relative to the pivot) to
+     * whole pixels, leaving some room for antialiasing */
+    sprite->x = floor(pivot + extents[0] * sx) - 1;
+    sprite->y = floor(pivot + extents[1] * sy) - 1;
+    x2 = ceil(pivot + extents[2] * sx) + 1;
+    y2 = ceil(pivot + extents[3] * sy) + 1;
+
+    sprite->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                 (x2 - sprite->x) * priv->scale,
+                                                 (y2 - sprite->y) * priv->scale);
+    cairo_surface_set_device_scale(sprite->surface, priv->scale, priv->scale);
+    cr = cairo_create(sprite->surface);
+    cairo_translate(cr, pivot - sprite->x, pivot - sprite->y);
+    cairo_scale(cr, sx, sy);
+    return cr;
+}
+
+static AgwGaugeSprite *
+get_bitmap_sprites(AgwGaugeRendererPrivate *priv, AgwGaugeHand hand)
+{
+    AgwGaugeSprite *sprite = priv->hand[hand].sprite;
+    AgwGaugeElement element[2];
+    gint i;
+
+    if (sprite[0].surface != NULL) {
+        return sprite;
+    }
+
+    element[0] = AGW_GAUGE_ELEMENT_HAND_SHADOW(hand);
+    element[1] = AGW_GAUGE_ELEMENT_HAND(hand);
+
+    /* Theme packs can provide these already rasterized */
+    for (i = 0; i < 2; ++i) {
+        sprite[i].surface = agw_gauge_theme_get_sprite(priv->theme, element[i],
+                                                       priv->size, priv->scale,
+                                                       &sprite[i].x, &sprite[i].y);
+    }
+
+    return sprite;
+}
+
+static AgwGaugeSprite *
+get_atlas_sprite(AgwGaugeRendererPrivate *priv, AgwGaugeHand hand, gdouble angle)
+{
+    AgwGaugeRendererHand *data = &priv->hand[hand];
+    AgwGaugeSprite *sprite;
+    gdouble extents[4];
+    cairo_t *cr;
+    gint n;
+
+    if (data->atlas == NULL) {
+        data->atlas = g_new0(AgwGaugeSprite, priv->hand_steps);
+    }
+
+    /* Sprites are rasterized lazily, the first time they are needed */
+    n = lround(angle * priv->hand_steps / (2*G_PI)) % (gint) priv->hand_steps;
+    if (n < 0) {
+        n += priv->hand_steps;
+    }
+    sprite = &data->atlas[n];
+    if (sprite->surface == NULL) {
+        angle = n * 2*G_PI / priv->hand_steps;
+        get_hand_extents(priv->theme, hand, angle, extents);
+        cr = sprite_init(priv, sprite, priv->size / 2., extents);
+        render_hand(priv->theme, cr, hand, angle);
+        cairo_destroy(cr);
+    }
+
+    return sprite;
+}
+
+static void
+render_layer(AgwGaugeRenderer *renderer, cairo_t *cr, gint size, gboolean foreground)
+{
+    AgwGaugeRendererPrivate *priv = agw_gauge_renderer_get_instance_private(renderer);
+    cairo_surface_t *surface;
+    gint scale;
+
+    scale = get_scale(cr);
+
+    g_mutex_lock(&priv->mutex);
+    if (priv->theme == NULL || size <= 0) {
+        g_mutex_unlock(&priv->mutex);
+        return;
+    }
+    use_size(priv, size, scale);
+    if (priv->layers == NULL) {
+        priv->layers = agw_gauge_theme_get_layers(priv->theme, size, scale);
+    }
+    surface = foreground ? priv->layers->foreground : priv->layers->background;
+    cairo_surface_reference(surface);
+    g_mutex_unlock(&priv->mutex);
+
+    /* Painting is done without the lock: the surface is never
+     * modified once rendered */
+    cairo_save(cr);
+    cairo_set_source_surface(cr, surface, 0, 0);
+    cairo_paint(cr);
+    cairo_restore(cr);
+    cairo_surface_destroy(surface);
+}
+
+static void
+finalize(GObject *object)
+{
+    AgwGaugeRenderer *renderer = AGW_GAUGE_RENDERER(object);
+    AgwGaugeRendererPrivate *priv = agw_gauge_renderer_get_instance_private(renderer);
+
+    free_cache(priv);
+    if (priv->theme != NULL) {
+        agw_gauge_theme_unref(priv->theme);
+        priv->theme = NULL;
+    }
+    g_mutex_clear(&priv->mutex);
+
+    G_OBJECT_CLASS(agw_gauge_renderer_parent_class)->finalize(object);
+}
+
+static void
+get_property(GObject *object, guint prop_id,
+             GValue *value, GParamSpec *pspec)
+{
+    AgwGaugeRenderer *renderer = AGW_GAUGE_RENDERER(object);
+
+    switch (prop_id) {
+    case PROP_HAND_MODE:
+        g_value_set_enum(value, agw_gauge_renderer_get_hand_mode(renderer));
+        break;
+    case PROP_HAND_STEPS:
+        g_value_set_uint(value, agw_gauge_renderer_get_hand_steps(renderer));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+set_property(GObject *object, guint prop_id,
+             const GValue *value, GParamSpec *pspec)
+{
+    AgwGaugeRenderer *renderer = AGW_GAUGE_RENDERER(object);
+
+    switch (prop_id) {
+    case PROP_HAND_MODE:
+        agw_gauge_renderer_set_hand_mode(renderer, g_value_get_enum(value));
+        break;
+    case PROP_HAND_STEPS:
+        agw_gauge_renderer_set_hand_steps(renderer, g_value_get_uint(value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+agw_gauge_renderer_class_init(AgwGaugeRendererClass *class)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+
+    object_class->finalize = finalize;
+    object_class->get_property = get_property;
+    object_class->set_property = set_property;
+
+    props[PROP_HAND_MODE] = g_param_spec_enum("hand-mode",
+                                              "Hand Mode",
+                                              "How the hands are rendered",
+                                              AGW_TYPE_GAUGE_HAND_MODE,
+                                              AGW_GAUGE_HAND_MODE_VECTOR,
+                                              G_PARAM_READWRITE);
+    props[PROP_HAND_STEPS] = g_param_spec_uint("hand-steps",
+                                               "Hand Steps",
+                                               "Number of pre-rotated hand sprites in atlas mode",
+                                               2, 3600, 120,
+                                               G_PARAM_READWRITE);
+
+    g_object_class_install_properties(object_class, NUM_PROPERTIES, props);
+}
+
+static void
+agw_gauge_renderer_init(AgwGaugeRenderer *renderer)
+{
+    AgwGaugeRendererPrivate *priv = agw_gauge_renderer_get_instance_private(renderer);
+    guint n;
+
+    g_mutex_init(&priv->mutex);
+    priv->theme      = NULL;
+    priv->hand_mode  = AGW_GAUGE_HAND_MODE_VECTOR;
+    priv->hand_steps = 120;
+    priv->size       = 0;
+    priv->scale      = 0;
+    priv->layers     = NULL;
+
+    for (n = 0; n < AGW_GAUGE_THEME_HANDS; ++n) {
+        priv->hand[n].sprite[0].surface = NULL;
+        priv->hand[n].sprite[1].surface = NULL;
+        priv->hand[n].atlas             = NULL;
+    }
+}
+
+
+/*
+ * agw_gauge_renderer_take_theme:
+ * @renderer: an #AgwGaugeRenderer
+ * @theme: (transfer full) (allow-none): the new theme
+ *
+ * Internal API: sets a theme already loaded by agw_gauge_theme_load().
+ */
+void
+agw_gauge_renderer_take_theme(AgwGaugeRenderer *renderer, AgwGaugeTheme *theme)
+{
+    AgwGaugeRendererPrivate *priv = agw_gauge_renderer_get_instance_private(renderer);
+    AgwGaugeTheme *old;
+
+    g_mutex_lock(&priv->mutex);
+    old = priv->theme;
+    priv->theme = theme;
+    free_cache(priv);
+    g_mutex_unlock(&priv->mutex);
+
+    if (old != NULL) {
+        agw_gauge_theme_unref(old);
+    }
+}
+
+/*
+ * agw_gauge_renderer_peek_theme:
+ * @renderer: an #AgwGaugeRenderer
+ *
+ * Internal API: gets the current theme of @renderer. The result is
+ * valid only as long as nobody else changes the theme.
+ *
+ * Returns: (transfer none): the theme or %NULL
+ */
+AgwGaugeTheme *
+agw_gauge_renderer_peek_theme(AgwGaugeRenderer *renderer)
+{
+    AgwGaugeRendererPrivate *priv = agw_gauge_renderer_get_instance_private(renderer);
+    AgwGaugeTheme *theme;
+
+    g_mutex_lock(&priv->mutex);
+    theme = priv->theme;
+    g_mutex_unlock(&priv->mutex);
+
+    return theme;
+}
+
+
+/**
+ * agw_gauge_hand_mode_get_type:
+ *
+ * Registers the #AgwGaugeHandMode enumeration in the type system.
+ *
+ * Returns: the #GType of #AgwGaugeHandMode
+ **/
+GType
+agw_gauge_hand_mode_get_type(void)
+{
+    static gsize type = 0;
+
+    if (g_once_init_enter(&type)) {
+        static const GEnumValue values[] = {
+            { AGW_GAUGE_HAND_MODE_VECTOR, "AGW_GAUGE_HAND_MODE_VECTOR", "vector" },
+            { AGW_GAUGE_HAND_MODE_BITMAP, "AGW_GAUGE_HAND_MODE_BITMAP", "bitmap" },
+            { AGW_GAUGE_HAND_MODE_ATLAS,  "AGW_GAUGE_HAND_MODE_ATLAS",  "atlas" },
+            { 0, NULL, NULL }
+        };
+        GType id = g_enum_register_static(g_intern_static_string("AgwGaugeHandMode"),
+                                          values);
+        g_once_init_leave(&type, id);
+    }
+
+    return type;
+}
+
+/**
+ * agw_gauge_renderer_new:
+ *
+ * Creates a new #AgwGaugeRenderer without any theme: use
+ * agw_gauge_renderer_set_theme() before rendering.
+ *
+ * Returns: (transfer full): the newly created renderer
+ **/
+AgwGaugeRenderer *
+agw_gauge_renderer_new(void)
+{
+    return g_object_new(AGW_TYPE_GAUGE_RENDERER, NULL);
+}
+
+/**
+ * agw_gauge_renderer_set_theme:
+ * @renderer: an #AgwGaugeRenderer
+ * @theme_dir: path to the new theme
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Sets the theme used by @renderer. See agw_gauge_set_theme() for
+ * details on themes. Themes are cached process-wide, so renderers and
+ * gauges using the same theme share the parsed SVG files and, at the
+ * same size, the static layers. If the theme cannot be loaded, the
+ * previous theme is kept.
+ *
+ * @return: TRUE if the theme has been succesfully changed.
+ **/
+gboolean
+agw_gauge_renderer_set_theme(AgwGaugeRenderer *renderer,
+                             const gchar *theme_dir, GError **error)
+{
+    AgwGaugeTheme *theme;
+    gint64 begin;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_RENDERER(renderer), FALSE);
+    g_return_val_if_fail(theme_dir != NULL, FALSE);
+    g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+    begin = agw_perf_begin();
+    theme = agw_gauge_theme_load(theme_dir, error);
+    agw_perf_end(AGW_PERF_THEME_LOAD, renderer, begin, "AgwGaugeRenderer.set_theme");
+    if (theme == NULL) {
+        return FALSE;
+    }
+
+    agw_gauge_renderer_take_theme(renderer, theme);
+    return TRUE;
+}
+
+/**
+ * agw_gauge_renderer_set_hand_mode:
+ * @renderer: an #AgwGaugeRenderer
+ * @mode: the new #AgwGaugeHandMode
+ *
+ * Sets how the hands are rendered.
+ **/
+void
+agw_gauge_renderer_set_hand_mode(AgwGaugeRenderer *renderer, AgwGaugeHandMode mode)
+{
+    AgwGaugeRendererPrivate *priv;
+    gboolean changed;
+
+    g_return_if_fail(AGW_IS_GAUGE_RENDERER(renderer));
+
+    priv = agw_gauge_renderer_get_instance_private(renderer);
+
+    g_mutex_lock(&priv->mutex);
+    changed = mode != priv->hand_mode;
+    if (changed) {
+        free_sprites(priv);
+        priv->hand_mode = mode;
+    }
+    g_mutex_unlock(&priv->mutex);
+
+    if (changed) {
+        g_object_notify_by_pspec(G_OBJECT(renderer), props[PROP_HAND_MODE]);
+    }
+}
+
+/**
+ * agw_gauge_renderer_get_hand_mode:
+ * @renderer: an #AgwGaugeRenderer
+ *
+ * Gets how the hands are rendered.
+ *
+ * @return: the current #AgwGaugeHandMode
+ **/
+AgwGaugeHandMode
+agw_gauge_renderer_get_hand_mode(AgwGaugeRenderer *renderer)
+{
+    AgwGaugeRendererPrivate *priv;
+    AgwGaugeHandMode mode;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_RENDERER(renderer), AGW_GAUGE_HAND_MODE_VECTOR);
+
+    priv = agw_gauge_renderer_get_instance_private(renderer);
+    g_mutex_lock(&priv->mutex);
+    mode = priv->hand_mode;
+    g_mutex_unlock(&priv->mutex);
+
+    return mode;
+}
+
+/**
+ * agw_gauge_renderer_set_hand_steps:
+ * @renderer: an #AgwGaugeRenderer
+ * @steps: number of sprites in a full turn
+ *
+ * Sets how many pre-rotated sprites cover a full turn when the hand
+ * mode is %AGW_GAUGE_HAND_MODE_ATLAS. In that mode, angles are rounded
+ * to the nearest step.
+ **/
+void
+agw_gauge_renderer_set_hand_steps(AgwGaugeRenderer *renderer, guint steps)
+{
+    AgwGaugeRendererPrivate *priv;
+    gboolean changed;
+
+    g_return_if_fail(AGW_IS_GAUGE_RENDERER(renderer));
+    g_return_if_fail(steps >= 2);
+
+    priv = agw_gauge_renderer_get_instance_private(renderer);
+
+    g_mutex_lock(&priv->mutex);
+    changed = steps != priv->hand_steps;
+    if (changed) {
+        free_sprites(priv);
+        priv->hand_steps = steps;
+    }
+    g_mutex_unlock(&priv->mutex);
+
+    if (changed) {
+        g_object_notify_by_pspec(G_OBJECT(renderer), props[PROP_HAND_STEPS]);
+    }
+}
+
+/**
+ * agw_gauge_renderer_get_hand_steps:
+ * @renderer: an #AgwGaugeRenderer
+ *
+ * Gets the angular resolution of the hand atlas.
+ *
+ * @return: the number of sprites in a full turn
+ **/
+guint
+agw_gauge_renderer_get_hand_steps(AgwGaugeRenderer *renderer)
+{
+    AgwGaugeRendererPrivate *priv;
+    guint steps;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_RENDERER(renderer), 0);
+
+    priv = agw_gauge_renderer_get_instance_private(renderer);
+    g_mutex_lock(&priv->mutex);
+    steps = priv->hand_steps;
+    g_mutex_unlock(&priv->mutex);
+
+    return steps;
+}
+
+/**
+ * agw_gauge_renderer_render:
+ * @renderer: an #AgwGaugeRenderer
+ * @cr: the cairo context to draw on
+ * @size: side of the gauge, in user units of @cr
+ * @angles: (array length=n_angles): angles of the hands, in radians
+ * @n_angles: number of items in @angles
+ *
+ * Draws a whole gauge in the square between (0, 0) and (@size, @size)
+ * of @cr. @angles[n] is the angle of the hand n (see #AgwGaugeHand):
+ * hands without an angle or with a NAN angle are not drawn.
+ *
+ * This is the same as calling agw_gauge_renderer_render_background(),
+ * agw_gauge_renderer_render_hand() for every hand and
+ * agw_gauge_renderer_render_foreground().
+ **/
+void
+agw_gauge_renderer_render(AgwGaugeRenderer *renderer, cairo_t *cr, gint size,
+                          const gdouble *angles, guint n_angles)
+{
+    guint n;
+
+    g_return_if_fail(AGW_IS_GAUGE_RENDERER(renderer));
+    g_return_if_fail(cr != NULL);
+    g_return_if_fail(angles != NULL || n_angles == 0);
+
+    agw_gauge_renderer_render_background(renderer, cr, size);
+    for (n = 0; n < MIN(n_angles, AGW_GAUGE_THEME_HANDS); ++n) {
+        if (!isnan(angles[n])) {
+            agw_gauge_renderer_render_hand(renderer, cr, size, n, angles[n]);
+        }
+    }
+    agw_gauge_renderer_render_foreground(renderer, cr, size);
+}
+
+/**
+ * agw_gauge_renderer_render_background:
+ * @renderer: an #AgwGaugeRenderer
+ * @cr: the cairo context to draw on
+ * @size: side of the gauge, in user units of @cr
+ *
+ * Draws the static elements below the hands.
+ **/
+void
+agw_gauge_renderer_render_background(AgwGaugeRenderer *renderer, cairo_t *cr, gint size)
+{
+    g_return_if_fail(AGW_IS_GAUGE_RENDERER(renderer));
+    g_return_if_fail(cr != NULL);
+
+    render_layer(renderer, cr, size, FALSE);
+}
+
+/**
+ * agw_gauge_renderer_render_hand:
+ * @renderer: an #AgwGaugeRenderer
+ * @cr: the cairo context to draw on
+ * @size: side of the gauge, in user units of @cr
+ * @hand: the #AgwGaugeHand to draw
+ * @angle: angle of @hand, in radians
+ *
+ * Draws @hand (and its shadow) rotated by @angle. Nothing is drawn if
+ * the theme does not provide @hand.
+ **/
+void
+agw_gauge_renderer_render_hand(AgwGaugeRenderer *renderer, cairo_t *cr, gint size,
+                               AgwGaugeHand hand, gdouble angle)
+{
+    AgwGaugeRendererPrivate *priv;
+    AgwGaugeTheme *theme;
+    AgwGaugeSprite sprite[2], *bitmap;
+    AgwGaugeHandMode mode;
+    gdouble sx, sy;
+    gint scale, i;
+
+    g_return_if_fail(AGW_IS_GAUGE_RENDERER(renderer));
+    g_return_if_fail(cr != NULL);
+    g_return_if_fail((guint) hand < AGW_GAUGE_THEME_HANDS);
+
+    priv = agw_gauge_renderer_get_instance_private(renderer);
+    scale = get_scale(cr);
+
+    g_mutex_lock(&priv->mutex);
+    theme = priv->theme;
+    if (theme == NULL || size <= 0 || !agw_gauge_theme_load_hand(theme, hand)) {
+        g_mutex_unlock(&priv->mutex);
+        return;
+    }
+
+    use_size(priv, size, scale);
+    mode = priv->hand_mode;
+    sx = (gdouble) size / theme->width;
+    sy = (gdouble) size / theme->height;
+
+    /* Grab references to what is needed, so the painting can be done
+     * without holding the lock */
+    switch (mode) {
+    case AGW_GAUGE_HAND_MODE_BITMAP:
+        bitmap = get_bitmap_sprites(priv, hand);
+        sprite[0] = bitmap[0];
+        sprite[1] = bitmap[1];
+        cairo_surface_reference(sprite[0].surface);
+        cairo_surface_reference(sprite[1].surface);
+        break;
+    case AGW_GAUGE_HAND_MODE_ATLAS:
+        sprite[0] = *get_atlas_sprite(priv, hand, angle);
+        cairo_surface_reference(sprite[0].surface);
+        sprite[1].surface = NULL;
+        break;
+    default:
+        agw_gauge_theme_ref(theme);
+        sprite[0].surface = sprite[1].surface = NULL;
+        break;
+    }
+    g_mutex_unlock(&priv->mutex);
+
+    cairo_save(cr);
+
+    switch (mode) {
+    case AGW_GAUGE_HAND_MODE_BITMAP:
+        cairo_save(cr);
+        cairo_translate(cr, size / 2. - 0.75 * sx, size / 2. + 0.75 * sy);
+        cairo_rotate(cr, angle);
+        cairo_set_source_surface(cr, sprite[0].surface, sprite[0].x, sprite[0].y);
+        cairo_paint(cr);
+        cairo_restore(cr);
+        cairo_translate(cr, size / 2., size / 2.);
+        cairo_rotate(cr, angle);
+        cairo_set_source_surface(cr, sprite[1].surface, sprite[1].x, sprite[1].y);
+        cairo_paint(cr);
+        break;
+
+    case AGW_GAUGE_HAND_MODE_ATLAS:
+        /* Atlas sprites are pixel aligned, so this is a plain copy */
+        cairo_set_source_surface(cr, sprite[0].surface, sprite[0].x, sprite[0].y);
+        cairo_paint(cr);
+        break;
+
+    default:
+        cairo_scale(cr, sx, sy);
+        cairo_translate(cr, theme->width / 2, theme->height / 2);
+        render_hand(theme, cr, hand, angle);
+        agw_gauge_theme_unref(theme);
+        break;
+    }
+
+    cairo_restore(cr);
+
+    for (i = 0; i < 2; ++i) {
+        if (sprite[i].surface != NULL) {
+            cairo_surface_destroy(sprite[i].surface);
+        }
+    }
+}
+
+/**
+ * agw_gauge_renderer_render_foreground:
+ * @renderer: an #AgwGaugeRenderer
+ * @cr: the cairo context to draw on
+ * @size: side of the gauge, in user units of @cr
+ *
+ * Draws the static elements above the hands.
+ **/
+void
+agw_gauge_renderer_render_foreground(AgwGaugeRenderer *renderer, cairo_t *cr, gint size)
+{
+    g_return_if_fail(AGW_IS_GAUGE_RENDERER(renderer));
+    g_return_if_fail(cr != NULL);
+
+    render_layer(renderer, cr, size, TRUE);
+}
+
+/**
+ * agw_gauge_renderer_get_hand_area:
+ * @renderer: an #AgwGaugeRenderer
+ * @size: side of the gauge
+ * @hand: an #AgwGaugeHand
+ * @angle: angle of @hand, in radians
+ * @area: (out): where to store the area covered by @hand
+ *
+ * Computes the area covered by @hand (and by its shadow) when rotated
+ * by @angle, relative to the top left corner of the gauge. The area
+ * is slightly enlarged to include antialiasing, so it can be used to
+ * invalidate only the region touched by a moving hand.
+ *
+ * @return: FALSE if the theme does not provide @hand.
+ **/
+gboolean
+agw_gauge_renderer_get_hand_area(AgwGaugeRenderer *renderer, gint size,
+                                 AgwGaugeHand hand, gdouble angle,
+                                 cairo_rectangle_int_t *area)
+{
+    AgwGaugeRendererPrivate *priv;
+    AgwGaugeTheme *theme;
+    gdouble extents[4];
+    gdouble pivot, sx, sy;
+
+    g_return_val_if_fail(AGW_IS_GAUGE_RENDERER(renderer), FALSE);
+    g_return_val_if_fail((guint) hand < AGW_GAUGE_THEME_HANDS, FALSE);
+    g_return_val_if_fail(area != NULL, FALSE);
+
+    priv = agw_gauge_renderer_get_instance_private(renderer);
+
+    g_mutex_lock(&priv->mutex);
+    theme = priv->theme;
+    if (theme == NULL || !agw_gauge_theme_load_hand(theme, hand)) {
+        g_mutex_unlock(&priv->mutex);
+        return FALSE;
+    }
+
+    pivot = size / 2.;
+    sx = (gdouble) size / theme->width;
+    sy = (gdouble) size / theme->height;
+    get_hand_extents(theme, hand, angle, extents);
+    g_mutex_unlock(&priv->mutex);
+
+    /* Be generous: antialiasing and bitmap interpolation can bleed */
+    area->x      = floor(pivot + extents[0] * sx) - 2;
+    area->y      = floor(pivot + extents[1] * sy) - 2;
+    area->width  = ceil(pivot + extents[2] * sx) + 2 - area->x;
+    area->height = ceil(pivot + extents[3] * sy) + 2 - area->y;
+
+    return TRUE;
+}
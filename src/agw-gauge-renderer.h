@@ -0,0 +1,112 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __AGW_GAUGE_RENDERER_H__
+#define __AGW_GAUGE_RENDERER_H__
+
+#include <glib-object.h>
+#include <cairo.h>
+
+
+G_BEGIN_DECLS
+
+/**
+ * AgwGaugeHandMode:
+ * @AGW_GAUGE_HAND_MODE_VECTOR: render the hand SVG on every frame
+ * @AGW_GAUGE_HAND_MODE_BITMAP: rasterize the hand once per size and
+ *                              draw a rotated copy of that bitmap
+ * @AGW_GAUGE_HAND_MODE_ATLAS: blit the nearest of a set of
+ *                             pre-rotated hand sprites
+ *
+ * How the hands of a gauge are rendered.
+ **/
+typedef enum {
+    AGW_GAUGE_HAND_MODE_VECTOR,
+    AGW_GAUGE_HAND_MODE_BITMAP,
+    AGW_GAUGE_HAND_MODE_ATLAS,
+} AgwGaugeHandMode;
+
+/**
+ * AgwGaugeHand:
+ * @AGW_GAUGE_HAND_HOUR: the hour hand of the theme
+ * @AGW_GAUGE_HAND_MINUTE: the minute hand of the theme, driven by the
+ *                         `GtkRange` adjustment in #AgwGauge
+ * @AGW_GAUGE_HAND_SECOND: the second hand of the theme
+ *
+ * The hands of a gauge, from bottom to top.
+ **/
+typedef enum {
+    AGW_GAUGE_HAND_HOUR,
+    AGW_GAUGE_HAND_MINUTE,
+    AGW_GAUGE_HAND_SECOND,
+} AgwGaugeHand;
+
+#define AGW_TYPE_GAUGE_HAND_MODE agw_gauge_hand_mode_get_type()
+#define AGW_TYPE_GAUGE_RENDERER agw_gauge_renderer_get_type()
+
+GType           agw_gauge_hand_mode_get_type(void) G_GNUC_CONST;
+
+G_DECLARE_FINAL_TYPE(AgwGaugeRenderer, agw_gauge_renderer, AGW, GAUGE_RENDERER, GObject)
+
+
+AgwGaugeRenderer *
+                agw_gauge_renderer_new      (void);
+gboolean        agw_gauge_renderer_set_theme(AgwGaugeRenderer * renderer,
+                                             const gchar *      theme_dir,
+                                             GError **          error);
+void            agw_gauge_renderer_set_hand_mode
+                                            (AgwGaugeRenderer * renderer,
+                                             AgwGaugeHandMode   mode);
+AgwGaugeHandMode
+                agw_gauge_renderer_get_hand_mode
+                                            (AgwGaugeRenderer * renderer);
+void            agw_gauge_renderer_set_hand_steps
+                                            (AgwGaugeRenderer * renderer,
+                                             guint              steps);
+guint           agw_gauge_renderer_get_hand_steps
+                                            (AgwGaugeRenderer * renderer);
+void            agw_gauge_renderer_render   (AgwGaugeRenderer * renderer,
+                                             cairo_t *          cr,
+                                             gint               size,
+                                             const gdouble *    angles,
+                                             guint              n_angles);
+void            agw_gauge_renderer_render_background
+                                            (AgwGaugeRenderer * renderer,
+                                             cairo_t *          cr,
+                                             gint               size);
+void            agw_gauge_renderer_render_hand
+                                            (AgwGaugeRenderer * renderer,
+                                             cairo_t *          cr,
+                                             gint               size,
+                                             AgwGaugeHand       hand,
+                                             gdouble            angle);
+void            agw_gauge_renderer_render_foreground
+                                            (AgwGaugeRenderer * renderer,
+                                             cairo_t *          cr,
+                                             gint               size);
+gboolean        agw_gauge_renderer_get_hand_area
+                                            (AgwGaugeRenderer * renderer,
+                                             gint               size,
+                                             AgwGaugeHand       hand,
+                                             gdouble            angle,
+                                             cairo_rectangle_int_t *area);
+
+G_END_DECLS
+
+
+#endif /* __AGW_GAUGE_RENDERER_H__ */
@@ -0,0 +1,750 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Process-wide cache of gauge themes.
+ *
+ * Themes are keyed by their canonical directory and by the modification
+ * time of every file, so gauges using the same theme share one set of
+ * parsed SVG documents while an updated theme is loaded anew. Only the
+ * static elements are parsed upfront: the hands are parsed the first
+ * time a gauge shows them, so unused hands never take memory. Every
+ * theme also keeps the static layers rasterized at the sizes currently
+ * in use. Both themes and layers are refcounted and released as soon
+ * as the last user drops them.
+ *
+ * Themes embedded as GResource are referenced by `resource://` URI:
+ * their SVG files are parsed straight from the resource data, without
+ * any filesystem access.
+ *
+ * A theme can also be a theme pack (see agw-gauge-pack.c): its layers
+ * and hand sprites are taken from the mapped file when available and
+ * its SVG elements are parsed only when something must be rendered
+ * from the vector data.
+ *
+ * Everything here can be used from any thread. RsvgHandle is not thread
+ * safe, so every rendering of a theme element is serialized by
+ * agw_gauge_theme_render().
+ */
+
+#include "agw-gauge-theme.h"
+#include "agw-gauge-pack.h"
+#include "agw-perf.h"
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <math.h>
+#include <string.h>
+
+#define RESOURCE_SCHEME "resource://"
+
+
+static const gchar *theme_file[AGW_GAUGE_ELEMENT_LAST] = {
+    "clock-drop-shadow.svg",
+    "clock-face.svg",
+    "clock-marks.svg",
+    "clock-hour-hand-shadow.svg",
+    "clock-minute-hand-shadow.svg",
+    "clock-second-hand-shadow.svg",
+    "clock-hour-hand.svg",
+    "clock-minute-hand.svg",
+    "clock-second-hand.svg",
+    "clock-face-shadow.svg",
+    "clock-glass.svg",
+    "clock-frame.svg",
+};
+
+/* Protects the cache and every refcount and layer table */
+G_LOCK_DEFINE_STATIC(cache);
+static GHashTable *cache = NULL;
+
+
+/* Returns: the resource path of @theme_dir, or NULL if not a resource */
+static const gchar *
+get_resource_path(const gchar *theme_dir)
+{
+    if (!g_str_has_prefix(theme_dir, RESOURCE_SCHEME)) {
+        return NULL;
+    }
+    return theme_dir + strlen(RESOURCE_SCHEME);
+}
+
+static gboolean
+is_pack(const gchar *theme_dir)
+{
+    return g_file_test(theme_dir, G_FILE_TEST_IS_REGULAR);
+}
+
+static void
+append_mtime(GString *key, const gchar *file)
+{
+    GStatBuf st;
+
+    if (g_stat(file, &st) == 0) {
+        g_string_append_printf(key, ":%" G_GINT64_FORMAT, (gint64) st.st_mtime);
+    } else {
+        g_string_append(key, ":-");
+    }
+}
+
+static gchar *
+build_key(const gchar *theme_dir)
+{
+    GString *key;
+    gchar *dir, *file;
+    gint i;
+
+    /* Resources cannot change while the process is running */
+    if (get_resource_path(theme_dir) != NULL) {
+        return g_strdup(theme_dir);
+    }
+
+    dir = g_canonicalize_filename(theme_dir, NULL);
+    key = g_string_new(dir);
+
+    if (is_pack(dir)) {
+        append_mtime(key, dir);
+    } else {
+        for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+            file = g_build_filename(dir, theme_file[i], NULL);
+            append_mtime(key, file);
+            g_free(file);
+        }
+    }
+
+    g_free(dir);
+    return g_string_free(key, FALSE);
+}
+
+static void
+get_ink_extents(AgwGaugeTheme *theme, AgwGaugeElement element, cairo_rectangle_t *ink)
+{
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    surface = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, NULL);
+    cr = cairo_create(surface);
+    agw_gauge_theme_render(theme, element, cr);
+    cairo_destroy(cr);
+    cairo_recording_surface_ink_extents(surface,
+                                        &ink->x, &ink->y,
+                                        &ink->width, &ink->height);
+    cairo_surface_destroy(surface);
+}
+
+static void
+theme_free(AgwGaugeTheme *theme)
+{
+    gint i;
+
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        if (theme->svg[i] != NULL) {
+            g_object_unref(G_OBJECT(theme->svg[i]));
+        }
+    }
+    agw_gauge_pack_free(theme->pack);
+    g_hash_table_destroy(theme->layers);
+    g_mutex_clear(&theme->hand_mutex);
+    g_mutex_clear(&theme->svg_mutex);
+    g_free(theme->dir);
+    g_free(theme->key);
+    g_free(theme);
+}
+
+static RsvgHandle *
+svg_parse(GBytes *bytes, GError **error)
+{
+    RsvgHandle *svg;
+    GInputStream *stream;
+
+    /* The stream reads directly from @bytes, without copying them */
+    stream = g_memory_input_stream_new_from_bytes(bytes);
+    svg = rsvg_handle_new_from_stream_sync(stream, NULL, RSVG_HANDLE_FLAGS_NONE,
+                                           NULL, error);
+    g_object_unref(stream);
+
+    return svg;
+}
+
+static GBytes *
+resource_lookup(const gchar *path, AgwGaugeElement element, GError **error)
+{
+    GBytes *bytes;
+    gchar *resource;
+
+    /* Uncompressed resources are returned without copying them */
+    resource = g_build_path("/", path, theme_file[element], NULL);
+    bytes = g_resources_lookup_data(resource, G_RESOURCE_LOOKUP_FLAGS_NONE, error);
+    g_free(resource);
+
+    return bytes;
+}
+
+static RsvgHandle *
+element_parse(const gchar *theme_dir, AgwGaugeElement element, GError **error)
+{
+    RsvgHandle *svg;
+    GBytes *bytes;
+    const gchar *path;
+    gchar *file;
+
+    path = get_resource_path(theme_dir);
+    if (path != NULL) {
+        bytes = resource_lookup(path, element, error);
+        if (bytes == NULL) {
+            return NULL;
+        }
+        svg = svg_parse(bytes, error);
+        g_bytes_unref(bytes);
+        return svg;
+    }
+
+    file = g_build_filename(theme_dir, theme_file[element], NULL);
+    svg = rsvg_handle_new_from_file(file, error);
+    g_free(file);
+
+    return svg;
+}
+
+static gboolean
+is_hand(AgwGaugeElement element)
+{
+    return element >= AGW_GAUGE_ELEMENT_HOUR_HAND_SHADOW &&
+           element <= AGW_GAUGE_ELEMENT_SECOND_HAND;
+}
+
+/* Parses an element of a theme pack: must be called with svg_mutex held */
+static RsvgHandle *
+element_unpack(AgwGaugeTheme *theme, AgwGaugeElement element)
+{
+    RsvgHandle *svg;
+    GBytes *bytes;
+    GError *error;
+
+    if (theme->svg_failed & (1 << element)) {
+        return NULL;
+    }
+
+    bytes = agw_gauge_pack_get_svg(theme->pack, element);
+    if (bytes == NULL) {
+        theme->svg_failed |= 1 << element;
+        return NULL;
+    }
+
+    error = NULL;
+    svg = svg_parse(bytes, &error);
+    if (svg == NULL) {
+        g_warning("Unable to parse %s from '%s': %s",
+                  theme_file[element], theme->dir, error->message);
+        g_error_free(error);
+        theme->svg_failed |= 1 << element;
+    }
+
+    g_bytes_unref(bytes);
+    return svg;
+}
+
+static gboolean
+pack_parse(AgwGaugeTheme *theme, GError **error)
+{
+    const AgwGaugePackHeader *header;
+    gint i, n;
+
+    theme->pack = agw_gauge_pack_open(theme->dir, error);
+    if (theme->pack == NULL) {
+        return FALSE;
+    }
+
+    header = theme->pack->header;
+    theme->width  = header->width;
+    theme->height = header->height;
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        theme->ink[i].x      = header->ink[i][0];
+        theme->ink[i].y      = header->ink[i][1];
+        theme->ink[i].width  = header->ink[i][2];
+        theme->ink[i].height = header->ink[i][3];
+    }
+
+    /* The ink extents are already known, so the hands can be used
+     * without parsing anything */
+    for (n = 0; n < AGW_GAUGE_THEME_HANDS; ++n) {
+        theme->hand_state[n] = header->svg[AGW_GAUGE_ELEMENT_HAND_SHADOW(n)].length > 0 &&
+                               header->svg[AGW_GAUGE_ELEMENT_HAND(n)].length > 0 ? 1 : -1;
+    }
+
+    return TRUE;
+}
+
+static AgwGaugeTheme *
+theme_parse(const gchar *theme_dir, gchar *key, GError **error)
+{
+    AgwGaugeTheme *theme;
+    RsvgDimensionData dimension;
+    gint i;
+
+    theme = g_new0(AgwGaugeTheme, 1);
+    theme->ref_count = 1;
+    theme->key = key;
+    theme->dir = g_strdup(theme_dir);
+    theme->layers = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_mutex_init(&theme->hand_mutex);
+    g_mutex_init(&theme->svg_mutex);
+
+    /* Nothing is parsed upfront from a theme pack */
+    if (is_pack(theme_dir)) {
+        if (!pack_parse(theme, error)) {
+            theme_free(theme);
+            return NULL;
+        }
+        return theme;
+    }
+
+    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
+        /* Hands are parsed by agw_gauge_theme_load_hand() */
+        if (is_hand(i)) {
+            continue;
+        }
+
+        theme->svg[i] = element_parse(theme_dir, i, error);
+
+        /* On errors, return NULL without further processing */
+        if (theme->svg[i] == NULL) {
+            g_assert(error == NULL || *error != NULL);
+            theme_free(theme);
+            return NULL;
+        }
+
+        /* Get the extents of the biggest element: hands are expected
+         * to share the same canvas of the static elements */
+        rsvg_handle_get_dimensions(theme->svg[i], &dimension);
+        theme->width  = MAX(dimension.width, theme->width);
+        theme->height = MAX(dimension.height, theme->height);
+    }
+
+    return theme;
+}
+
+static cairo_surface_t *
+render_layer(AgwGaugeTheme *theme, gint size, gint scale,
+             AgwGaugeElement first, AgwGaugeElement last)
+{
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    gint i;
+
+    if (theme->pack != NULL) {
+        surface = agw_gauge_pack_get_image(theme->pack,
+                                           first == AGW_GAUGE_ELEMENT_DROP_SHADOW ?
+                                           AGW_GAUGE_PACK_BACKGROUND :
+                                           AGW_GAUGE_PACK_FOREGROUND,
+                                           0, size, scale, NULL, NULL);
+        if (surface != NULL) {
+            return surface;
+        }
+    }
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                         size * scale, size * scale);
+    cairo_surface_set_device_scale(surface, scale, scale);
+
+    cr = cairo_create(surface);
+    cairo_scale(cr, (gdouble) size / theme->width, (gdouble) size / theme->height);
+    for (i = first; i <= last; ++i) {
+        agw_gauge_theme_render(theme, i, cr);
+    }
+    cairo_destroy(cr);
+
+    return surface;
+}
+
+static void
+layers_free(AgwGaugeLayers *layers)
+{
+    cairo_surface_destroy(layers->background);
+    cairo_surface_destroy(layers->foreground);
+    agw_gauge_theme_unref(layers->theme);
+    g_free(layers);
+}
+
+
+/*
+ * agw_gauge_theme_load:
+ * @theme_dir: path to the theme
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Gets the theme stored in @theme_dir, parsing it only if it is not
+ * already in the cache.
+ *
+ * Returns: (transfer full): the theme or %NULL on errors
+ */
+AgwGaugeTheme *
+agw_gauge_theme_load(const gchar *theme_dir, GError **error)
+{
+    AgwGaugeTheme *theme, *cached;
+    gchar *key;
+
+    key = build_key(theme_dir);
+
+    G_LOCK(cache);
+    theme = cache != NULL ? g_hash_table_lookup(cache, key) : NULL;
+    if (theme != NULL) {
+        ++theme->ref_count;
+    }
+    G_UNLOCK(cache);
+
+    if (theme != NULL) {
+        agw_perf_count(AGW_PERF_THEME_HIT, NULL);
+        g_free(key);
+        return theme;
+    }
+
+    agw_perf_count(AGW_PERF_THEME_MISS, NULL);
+
+    /* Parsing is slow, so it is done without holding the lock */
+    theme = theme_parse(theme_dir, key, error);
+    if (theme == NULL) {
+        return NULL;
+    }
+
+    /* The same theme could have been loaded in the meantime */
+    G_LOCK(cache);
+    if (cache == NULL) {
+        cache = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+    cached = g_hash_table_lookup(cache, theme->key);
+    if (cached != NULL) {
+        ++cached->ref_count;
+    } else {
+        g_hash_table_insert(cache, theme->key, theme);
+    }
+    G_UNLOCK(cache);
+
+    if (cached != NULL) {
+        theme_free(theme);
+        return cached;
+    }
+
+    return theme;
+}
+
+AgwGaugeTheme *
+agw_gauge_theme_ref(AgwGaugeTheme *theme)
+{
+    G_LOCK(cache);
+    ++theme->ref_count;
+    G_UNLOCK(cache);
+
+    return theme;
+}
+
+void
+agw_gauge_theme_unref(AgwGaugeTheme *theme)
+{
+    gboolean last;
+
+    G_LOCK(cache);
+    last = --theme->ref_count == 0;
+    if (last) {
+        g_hash_table_remove(cache, theme->key);
+        if (g_hash_table_size(cache) == 0) {
+            g_hash_table_destroy(cache);
+            cache = NULL;
+        }
+    }
+    G_UNLOCK(cache);
+
+    if (last) {
+        theme_free(theme);
+    }
+}
+
+/*
+ * agw_gauge_theme_load_hand:
+ * @theme: an #AgwGaugeTheme
+ * @n: the hand to load: 0 for hour, 1 for minute and 2 for second
+ *
+ * Parses the elements of the @n-th hand (the hand and its shadow) of
+ * @theme, if not already done. This is thread safe and cheap after
+ * the first call. Failures are logged once and not retried.
+ *
+ * Returns: %TRUE if the hand elements of @theme can be used
+ */
+gboolean
+agw_gauge_theme_load_hand(AgwGaugeTheme *theme, guint n)
+{
+    AgwGaugeElement element[2];
+    GError *error;
+    gint i, state;
+
+    g_return_val_if_fail(n < AGW_GAUGE_THEME_HANDS, FALSE);
+
+    state = g_atomic_int_get(&theme->hand_state[n]);
+    if (state != 0) {
+        return state > 0;
+    }
+
+    element[0] = AGW_GAUGE_ELEMENT_HAND_SHADOW(n);
+    element[1] = AGW_GAUGE_ELEMENT_HAND(n);
+
+    g_mutex_lock(&theme->hand_mutex);
+
+    /* Check again: another thread could have loaded it meanwhile */
+    state = theme->hand_state[n];
+    for (i = 0; state == 0 && i < 2; ++i) {
+        error = NULL;
+        theme->svg[element[i]] = element_parse(theme->dir, element[i], &error);
+        if (theme->svg[element[i]] == NULL) {
+            g_warning("Unable to load hand from '%s': %s",
+                      theme->dir, error->message);
+            g_error_free(error);
+            state = -1;
+        }
+    }
+    if (state == 0) {
+        get_ink_extents(theme, element[0], &theme->ink[element[0]]);
+        get_ink_extents(theme, element[1], &theme->ink[element[1]]);
+        state = 1;
+    }
+    g_atomic_int_set(&theme->hand_state[n], state);
+
+    g_mutex_unlock(&theme->hand_mutex);
+
+    return state > 0;
+}
+
+/*
+ * agw_gauge_theme_render:
+ * @theme: an #AgwGaugeTheme
+ * @element: the element to render
+ * @cr: a cairo context in theme units
+ *
+ * Renders @element of @theme on @cr. This is the only way theme
+ * elements should be rendered, as it prevents the same RsvgHandle
+ * from being used by different threads at the same time.
+ */
+void
+agw_gauge_theme_render(AgwGaugeTheme *theme, AgwGaugeElement element, cairo_t *cr)
+{
+    g_mutex_lock(&theme->svg_mutex);
+    if (theme->svg[element] == NULL && theme->pack != NULL) {
+        /* Vector fallback of a theme pack */
+        theme->svg[element] = element_unpack(theme, element);
+    }
+    if (theme->svg[element] != NULL) {
+        rsvg_handle_render_cairo(theme->svg[element], cr);
+    }
+    g_mutex_unlock(&theme->svg_mutex);
+}
+
+/*
+ * agw_gauge_theme_get_layers:
+ * @theme: an #AgwGaugeTheme
+ * @size: size of the layers, in logical pixels
+ * @scale: scale factor of the target device
+ *
+ * Gets the static layers of @theme rasterized at @size, rendering
+ * them only if no other gauge is using the same size and the theme
+ * pack, if any, does not include them.
+ *
+ * Returns: (transfer full): the layers, to be released with
+ *          agw_gauge_layers_unref()
+ */
+AgwGaugeLayers *
+agw_gauge_theme_get_layers(AgwGaugeTheme *theme, gint size, gint scale)
+{
+    AgwGaugeLayers *layers, *cached;
+    gpointer key;
+
+    key = GUINT_TO_POINTER(((guint) size << 8) | (scale & 0xFF));
+
+    G_LOCK(cache);
+    layers = g_hash_table_lookup(theme->layers, key);
+    if (layers != NULL) {
+        ++layers->ref_count;
+    }
+    G_UNLOCK(cache);
+
+    if (layers != NULL) {
+        agw_perf_count(AGW_PERF_LAYERS_HIT, NULL);
+        return layers;
+    }
+
+    agw_perf_count(AGW_PERF_LAYERS_MISS, NULL);
+
+    layers = g_new0(AgwGaugeLayers, 1);
+    layers->ref_count  = 1;
+    layers->theme      = agw_gauge_theme_ref(theme);
+    layers->size       = size;
+    layers->scale      = scale;
+    layers->background = render_layer(theme, size, scale,
+                                      AGW_GAUGE_ELEMENT_DROP_SHADOW,
+                                      AGW_GAUGE_ELEMENT_MARKS);
+    layers->foreground = render_layer(theme, size, scale,
+                                      AGW_GAUGE_ELEMENT_FACE_SHADOW,
+                                      AGW_GAUGE_ELEMENT_FRAME);
+
+    G_LOCK(cache);
+    cached = g_hash_table_lookup(theme->layers, key);
+    if (cached != NULL) {
+        ++cached->ref_count;
+    } else {
+        g_hash_table_insert(theme->layers, key, layers);
+    }
+    G_UNLOCK(cache);
+
+    if (cached != NULL) {
+        layers_free(layers);
+        return cached;
+    }
+
+    return layers;
+}
+
+void
+agw_gauge_layers_unref(AgwGaugeLayers *layers)
+{
+    gpointer key;
+    gboolean last;
+
+    key = GUINT_TO_POINTER(((guint) layers->size << 8) | (layers->scale & 0xFF));
+
+    G_LOCK(cache);
+    last = --layers->ref_count == 0;
+    if (last) {
+        g_hash_table_remove(layers->theme->layers, key);
+    }
+    G_UNLOCK(cache);
+
+    if (last) {
+        layers_free(layers);
+    }
+}
+
+/*
+ * agw_gauge_theme_get_sprite_area:
+ * @theme: an #AgwGaugeTheme
+ * @element: a hand or hand shadow element
+ * @size: size of the gauge, in logical pixels
+ * @area: (out): where to store the area of the sprite
+ *
+ * Computes the area covered by the sprite of @element returned by
+ * agw_gauge_theme_get_sprite(), relative to the pivot and in logical
+ * pixels. The hand must have been loaded.
+ */
+void
+agw_gauge_theme_get_sprite_area(AgwGaugeTheme *theme, AgwGaugeElement element,
+                                gint size, cairo_rectangle_int_t *area)
+{
+    const cairo_rectangle_t *ink = &theme->ink[element];
+    gdouble sx, sy;
+
+    /* Convert the ink extents to whole pixels, leaving some room for
+     * antialiasing */
+    sx = (gdouble) size / theme->width;
+    sy = (gdouble) size / theme->height;
+    area->x      = floor(ink->x * sx) - 1;
+    area->y      = floor(ink->y * sy) - 1;
+    area->width  = ceil((ink->x + ink->width) * sx) + 1 - area->x;
+    area->height = ceil((ink->y + ink->height) * sy) + 1 - area->y;
+}
+
+/*
+ * agw_gauge_theme_get_sprite:
+ * @theme: an #AgwGaugeTheme
+ * @element: a hand or hand shadow element
+ * @size: size of the gauge, in logical pixels
+ * @scale: scale factor of the target device
+ * @x: (out): where to store the x offset of the sprite from the pivot
+ * @y: (out): where to store the y offset of the sprite from the pivot
+ *
+ * Gets @element, not rotated, rasterized at @size. The hand must have
+ * been loaded with agw_gauge_theme_load_hand(). The sprite is taken
+ * from the theme pack, if included, or rendered from the SVG.
+ *
+ * Returns: (transfer full): the sprite
+ */
+cairo_surface_t *
+agw_gauge_theme_get_sprite(AgwGaugeTheme *theme, AgwGaugeElement element,
+                           gint size, gint scale, gint *x, gint *y)
+{
+    cairo_rectangle_int_t area;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    if (theme->pack != NULL) {
+        surface = agw_gauge_pack_get_image(theme->pack, AGW_GAUGE_PACK_SPRITE,
+                                           element, size, scale, x, y);
+        if (surface != NULL) {
+            return surface;
+        }
+    }
+
+    agw_gauge_theme_get_sprite_area(theme, element, size, &area);
+    *x = area.x;
+    *y = area.y;
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                         area.width * scale, area.height * scale);
+    cairo_surface_set_device_scale(surface, scale, scale);
+    cr = cairo_create(surface);
+    cairo_translate(cr, -area.x, -area.y);
+    cairo_scale(cr, (gdouble) size / theme->width, (gdouble) size / theme->height);
+    agw_gauge_theme_render(theme, element, cr);
+    cairo_destroy(cr);
+
+    return surface;
+}
+
+/*
+ * agw_gauge_theme_get_svg:
+ * @theme: an #AgwGaugeTheme
+ * @element: an #AgwGaugeElement
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Gets the SVG source of @element, e.g. to compile @theme into a pack.
+ *
+ * Returns: (transfer full): the source or %NULL on errors
+ */
+GBytes *
+agw_gauge_theme_get_svg(AgwGaugeTheme *theme, AgwGaugeElement element, GError **error)
+{
+    GBytes *bytes;
+    const gchar *path;
+    gchar *file, *contents;
+    gsize length;
+
+    path = get_resource_path(theme->dir);
+    if (path != NULL) {
+        return resource_lookup(path, element, error);
+    }
+
+    if (theme->pack != NULL) {
+        bytes = agw_gauge_pack_get_svg(theme->pack, element);
+        if (bytes == NULL) {
+            g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                        "'%s' does not contain %s", theme->dir, theme_file[element]);
+        }
+        return bytes;
+    }
+
+    file = g_build_filename(theme->dir, theme_file[element], NULL);
+    bytes = g_file_get_contents(file, &contents, &length, error) ?
+            g_bytes_new_take(contents, length) : NULL;
+    g_free(file);
+
+    return bytes;
+}
@@ -0,0 +1,142 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Private header: not installed and not part of the public API */
+
+#ifndef __AGW_GAUGE_THEME_H__
+#define __AGW_GAUGE_THEME_H__
+
+#include <glib.h>
+#include <cairo.h>
+#include <librsvg/rsvg.h>
+#include "agw-gauge-renderer.h"
+
+
+G_BEGIN_DECLS
+
+/* The default theme, embedded in the library */
+#define AGW_GAUGE_THEME_DEFAULT             "resource:///org/entidi/agw/assets"
+
+typedef enum {
+    AGW_GAUGE_ELEMENT_DROP_SHADOW,
+    AGW_GAUGE_ELEMENT_FACE,
+    AGW_GAUGE_ELEMENT_MARKS,
+    AGW_GAUGE_ELEMENT_HOUR_HAND_SHADOW,
+    AGW_GAUGE_ELEMENT_MINUTE_HAND_SHADOW,
+    AGW_GAUGE_ELEMENT_SECOND_HAND_SHADOW,
+    AGW_GAUGE_ELEMENT_HOUR_HAND,
+    AGW_GAUGE_ELEMENT_MINUTE_HAND,
+    AGW_GAUGE_ELEMENT_SECOND_HAND,
+    AGW_GAUGE_ELEMENT_FACE_SHADOW,
+    AGW_GAUGE_ELEMENT_GLASS,
+    AGW_GAUGE_ELEMENT_FRAME,
+    AGW_GAUGE_ELEMENT_LAST,
+} AgwGaugeElement;
+
+/* Elements of the n-th hand (0 = hour, 1 = minute, 2 = second) */
+#define AGW_GAUGE_ELEMENT_HAND_SHADOW(n)    (AGW_GAUGE_ELEMENT_HOUR_HAND_SHADOW + (n))
+#define AGW_GAUGE_ELEMENT_HAND(n)           (AGW_GAUGE_ELEMENT_HOUR_HAND + (n))
+#define AGW_GAUGE_THEME_HANDS               3
+
+typedef struct _AgwGaugeTheme AgwGaugeTheme;
+typedef struct _AgwGaugeLayers AgwGaugeLayers;
+typedef struct _AgwGaugePack AgwGaugePack;
+
+/* A parsed theme, shared by every gauge using the same files.
+ * All fields are read-only once the theme has been loaded, with the
+ * exception of the hand elements: they are parsed on demand by
+ * agw_gauge_theme_load_hand() and are read-only after that call
+ * returned TRUE. */
+struct _AgwGaugeTheme {
+    gint                ref_count;
+    gchar *             key;
+    gchar *             dir;
+    /* Not NULL if the theme has been loaded from a theme pack */
+    AgwGaugePack *      pack;
+    RsvgHandle *        svg[AGW_GAUGE_ELEMENT_LAST];
+    gint                width;
+    gint                height;
+
+    /* Ink extents of the hand elements, in theme units and relative to
+     * the rotation pivot (only meaningful for hands and their shadows) */
+    cairo_rectangle_t   ink[AGW_GAUGE_ELEMENT_LAST];
+
+    /* Lazy loading of the hands: 0 not loaded, 1 loaded, -1 failed */
+    GMutex              hand_mutex;
+    gint                hand_state[AGW_GAUGE_THEME_HANDS];
+
+    /* Serializes the access to the RsvgHandle instances */
+    GMutex              svg_mutex;
+    /* Elements of a pack whose SVG cannot be parsed, as a bitmask */
+    guint               svg_failed;
+
+    /* AgwGaugeLayers instances, keyed by size and scale */
+    GHashTable *        layers;
+};
+
+/* The static parts of a theme rasterized at a specific size */
+struct _AgwGaugeLayers {
+    gint                ref_count;
+    AgwGaugeTheme *     theme;
+    gint                size;
+    gint                scale;
+    cairo_surface_t *   background;
+    cairo_surface_t *   foreground;
+};
+
+
+AgwGaugeTheme * agw_gauge_theme_load        (const gchar *      theme_dir,
+                                             GError **          error);
+AgwGaugeTheme * agw_gauge_theme_ref         (AgwGaugeTheme *    theme);
+void            agw_gauge_theme_unref       (AgwGaugeTheme *    theme);
+gboolean        agw_gauge_theme_load_hand   (AgwGaugeTheme *    theme,
+                                             guint              n);
+void            agw_gauge_theme_render      (AgwGaugeTheme *    theme,
+                                             AgwGaugeElement    element,
+                                             cairo_t *          cr);
+AgwGaugeLayers *agw_gauge_theme_get_layers  (AgwGaugeTheme *    theme,
+                                             gint               size,
+                                             gint               scale);
+void            agw_gauge_theme_get_sprite_area
+                                            (AgwGaugeTheme *    theme,
+                                             AgwGaugeElement    element,
+                                             gint               size,
+                                             cairo_rectangle_int_t *area);
+cairo_surface_t *
+                agw_gauge_theme_get_sprite  (AgwGaugeTheme *    theme,
+                                             AgwGaugeElement    element,
+                                             gint               size,
+                                             gint               scale,
+                                             gint *             x,
+                                             gint *             y);
+GBytes *        agw_gauge_theme_get_svg     (AgwGaugeTheme *    theme,
+                                             AgwGaugeElement    element,
+                                             GError **          error);
+void            agw_gauge_layers_unref      (AgwGaugeLayers *   layers);
+
+/* Internal API of AgwGaugeRenderer, used by AgwGauge */
+void            agw_gauge_renderer_take_theme
+                                            (AgwGaugeRenderer * renderer,
+                                             AgwGaugeTheme *    theme);
+AgwGaugeTheme * agw_gauge_renderer_peek_theme
+                                            (AgwGaugeRenderer * renderer);
+
+G_END_DECLS
+
+
+#endif /* __AGW_GAUGE_THEME_H__ */
@@ -27,12 +27,54 @@
  * The limits can be set by setting the upper and lower values of the
  * underlying `GtkAdjustment`. The agw_gauge_set_value() method can be
  * used instead of gtk_range_set_value() when you want the value to be
- * wrapped around instead of clamped inside the limits.
+ * wrapped around instead of clamped inside the limits. In that case
+ * the number of whole turns is tracked by the `revolutions` property,
+ * so raw counters (e.g. the absolute count of an encoder) can be fed
+ * directly to the gauge.
  *
  * The origin (i.e. the position of the clock hand when the value is at
  * minimum) can be defined by setting the `fill-level` property to the
  * proper angle (in radiants). By default the origin is north, that is
  * the fill level is set to `-G_PI_2`.
+ *
+ * The hand driven by the `GtkRange` is the minute hand of the theme.
+ * Up to two more hands (hour and second) can be shown, each one with
+ * its own adjustment, origin and direction: see
+ * agw_gauge_set_hand_adjustment(). This allows e.g. to show target and
+ * actual positions, or coarse and fine turns, in the same gauge. The
+ * SVG of a hand is parsed only when a gauge shows that hand.
+ *
+ * The drawing is delegated to an #AgwGaugeRenderer, that can also be
+ * used on its own to render gauges without GTK. The static parts of
+ * the theme (everything below and above the hands) are rasterized once
+ * into two layers at the current size and scale factor, so redrawing
+ * the gauge only renders the hands. Those layers are rebuilt when the
+ * widget is resized, when its scale factor changes or when a new theme
+ * is set.
+ *
+ * How the hand itself is rendered depends on the `hand-mode` property.
+ * By default (%AGW_GAUGE_HAND_MODE_VECTOR) the SVG is rendered on every
+ * frame. %AGW_GAUGE_HAND_MODE_BITMAP rasterizes the hand once per size
+ * and draws a rotated copy of that bitmap, while
+ * %AGW_GAUGE_HAND_MODE_ATLAS keeps up to `hand-steps` pre-rotated
+ * sprites and blits the one nearest to the current angle. In both
+ * cases the per-frame cost no longer depends on the SVG complexity.
+ *
+ * When the value changes, only the area swept by the hand (and by its
+ * shadow) is invalidated, so the redraw of large gauges is limited to
+ * the pixels that actually changed.
+ *
+ * Setting the `damping` property to a value greater than 0 makes the
+ * hand move smoothly towards its new position at display rate instead
+ * of jumping there. This gives fluid motion even when the value is
+ * updated a few times per second. The animation is driven by the frame
+ * clock and stops as soon as the hand settles, so an idle gauge causes
+ * no wakeups.
+ *
+ * The default theme is embedded in the library and is loaded only when
+ * the gauge is realized or drawn without any other theme set.
+ * agw_gauge_set_theme_async() can be used to parse a theme on a worker
+ * thread: the current theme stays on screen until the new one is ready.
  **/
 
 /**
@@ -43,56 +85,89 @@
  **/
 
 #include "agw-gauge.h"
+#include "agw-gauge-theme.h"
+#include "agw-perf.h"
 #include <math.h>
-#include <librsvg/rsvg.h>
-
-
-typedef enum {
-    AGW_GAUGE_ELEMENT_DROP_SHADOW,
-    AGW_GAUGE_ELEMENT_FACE,
-    AGW_GAUGE_ELEMENT_MARKS,
-    AGW_GAUGE_ELEMENT_HOUR_HAND_SHADOW,
-    AGW_GAUGE_ELEMENT_MINUTE_HAND_SHADOW,
-    AGW_GAUGE_ELEMENT_SECOND_HAND_SHADOW,
-    AGW_GAUGE_ELEMENT_HOUR_HAND,
-    AGW_GAUGE_ELEMENT_MINUTE_HAND,
-    AGW_GAUGE_ELEMENT_SECOND_HAND,
-    AGW_GAUGE_ELEMENT_FACE_SHADOW,
-    AGW_GAUGE_ELEMENT_GLASS,
-    AGW_GAUGE_ELEMENT_FRAME,
-    AGW_GAUGE_ELEMENT_LAST,
-} AgwGaugeElement;
+
+
+#define N_HANDS (AGW_GAUGE_HAND_SECOND + 1)
 
 typedef struct {
-    RsvgHandle *svg[AGW_GAUGE_ELEMENT_LAST];
-    gint        width;
-    gint        height;
+    /* %NULL when the hand is hidden. The minute hand always uses the
+     * adjustment of the underlying GtkRange: it is kept here only to
+     * track its changes */
+    GtkAdjustment *     adjustment;
+    gulong              changed_id;
+    gulong              value_changed_id;
+    gdouble             origin;
+    gboolean            inverted;
+
+    /* Angle currently on screen and the animated one */
+    gdouble             drawn_angle;
+    gdouble             shown_angle;
+} AgwGaugeHandData;
+
+typedef struct {
+    gchar *             theme_dir;
+    guint               hands;
+} AgwGaugeThemeLoad;
+
+typedef struct {
+    /* All the drawing is delegated to the renderer */
+    AgwGaugeRenderer *  renderer;
+    guint               theme_serial;
+    guint               theme_pending;
+
+    /* Whether the hands are on screen at their drawn_angle */
+    gboolean            drawn;
+
+    /* Hand animation */
+    gdouble             damping;
+    guint               tick_id;
+    gint64              frame_time;
+
+    /* Whole turns of the last value set by agw_gauge_set_value() */
+    gint64              revolutions;
+
+    AgwGaugeHandData    hand[N_HANDS];
 } AgwGaugePrivate;
 
 struct _AgwGauge {
     GtkRange parent_instance;
 };
 
+enum {
+    PROP_0,
+    PROP_HAND_MODE,
+    PROP_HAND_STEPS,
+    PROP_DAMPING,
+    PROP_REVOLUTIONS,
+    PROP_HOUR_ADJUSTMENT,
+    PROP_HOUR_ORIGIN,
+    PROP_HOUR_INVERTED,
+    PROP_SECOND_ADJUSTMENT,
+    PROP_SECOND_ORIGIN,
+    PROP_SECOND_INVERTED,
+    NUM_PROPERTIES,
+};
+
+static GParamSpec *props[NUM_PROPERTIES] = { 0 };
 
-static const gchar *theme_file[AGW_GAUGE_ELEMENT_LAST] = {
-    "clock-drop-shadow.svg",
-    "clock-face.svg",
-    "clock-marks.svg",
-    "clock-hour-hand-shadow.svg",
-    "clock-minute-hand-shadow.svg",
-    "clock-second-hand-shadow.svg",
-    "clock-hour-hand.svg",
-    "clock-minute-hand.svg",
-    "clock-second-hand.svg",
-    "clock-face-shadow.svg",
-    "clock-glass.svg",
-    "clock-frame.svg",
+enum {
+    WRAPPED,
+    NUM_SIGNALS,
 };
 
+static guint signals[NUM_SIGNALS] = { 0 };
+
 
 G_DEFINE_TYPE_WITH_PRIVATE(AgwGauge, agw_gauge, GTK_TYPE_RANGE)
 
 
+static void     hand_moved                  (AgwGauge *     gauge);
+static void     queue_full_redraw           (AgwGauge *     gauge);
+
+
 static void
 get_preferred_width_or_height(GtkWidget *widget, gint *minimum, gint *natural)
 {
@@ -100,107 +175,524 @@ get_preferred_width_or_height(GtkWidget *widget, gint *minimum, gint *natural)
     *natural = 200;
 }
 
-static gboolean
-draw(GtkWidget *widget, cairo_t *cr)
+static GtkAdjustment *
+get_adjustment(AgwGauge *gauge, AgwGaugeHand hand)
 {
-    AgwGauge *gauge = AGW_GAUGE(widget);
     AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
-    GtkRange *range = GTK_RANGE(widget);
-    GtkAdjustment *adjustment = gtk_range_get_adjustment(range);
-    GtkAllocation room;
-    gdouble size, lower, upper, angle;
 
-    gtk_widget_get_allocation(widget, &room);
-    size = MIN(room.width, room.height);
+    if (hand == AGW_GAUGE_HAND_MINUTE) {
+        return gtk_range_get_adjustment(GTK_RANGE(gauge));
+    }
+    return priv->hand[hand].adjustment;
+}
 
-    cairo_translate(cr, (room.width - size) / 2, (room.height - size) / 2);
-    cairo_scale(cr, size / priv->width, size / priv->height);
+static gdouble
+get_origin(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+
+    if (hand == AGW_GAUGE_HAND_MINUTE) {
+        return gtk_range_get_fill_level(GTK_RANGE(gauge));
+    }
+    return priv->hand[hand].origin;
+}
+
+static gboolean
+get_inverted(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+
+    if (hand == AGW_GAUGE_HAND_MINUTE) {
+        return gtk_range_get_inverted(GTK_RANGE(gauge));
+    }
+    return priv->hand[hand].inverted;
+}
 
-    /* Clear the surface */
-    cairo_set_source_rgba(cr, 1, 1, 1, 0);
-    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
-    cairo_paint(cr);
+static gboolean
+is_shown(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    return get_adjustment(gauge, hand) != NULL;
+}
 
-    /* Draw the background */
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_DROP_SHADOW], cr);
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_FACE], cr);
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_MARKS], cr);
+static gdouble
+get_target_angle(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    GtkAdjustment *adjustment = get_adjustment(gauge, hand);
+    gdouble lower, upper, angle;
 
-    /* Draw the hand */
     lower = gtk_adjustment_get_lower(adjustment);
     upper = gtk_adjustment_get_upper(adjustment);
     angle = gtk_adjustment_get_value(adjustment) * 2*G_PI / (upper - lower);
-    if (gtk_range_get_inverted(range)) {
+    if (get_inverted(gauge, hand)) {
         angle = -angle;
     }
-    angle += gtk_range_get_fill_level(GTK_RANGE(widget));
+    angle += get_origin(gauge, hand);
 
-    cairo_save(cr);
-    cairo_translate(cr, priv->width / 2, priv->height / 2);
-    cairo_save(cr);
-    cairo_translate(cr, -0.75, 0.75);
-    cairo_rotate(cr, angle);
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_MINUTE_HAND_SHADOW], cr);
-    cairo_restore(cr);
-    cairo_rotate(cr, angle);
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_MINUTE_HAND], cr);
-    cairo_restore(cr);
+    return angle;
+}
 
-    /* Draw the foreground */
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_FACE_SHADOW], cr);
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_GLASS], cr);
-    rsvg_handle_render_cairo(priv->svg[AGW_GAUGE_ELEMENT_FRAME], cr);
+static gdouble
+get_raw_angle(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
 
-    return FALSE;
+    /* While animating, the hands lag behind their values */
+    if (priv->tick_id != 0) {
+        return priv->hand[hand].shown_angle;
+    }
+    return get_target_angle(gauge, hand);
+}
+
+static gdouble
+quantize_angle(AgwGauge *gauge, gdouble angle)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    AgwGaugeRenderer *renderer = priv->renderer;
+    guint steps;
+
+    /* In atlas mode the hand can only be drawn at discrete angles */
+    if (agw_gauge_renderer_get_hand_mode(renderer) == AGW_GAUGE_HAND_MODE_ATLAS) {
+        steps = agw_gauge_renderer_get_hand_steps(renderer);
+        angle = lround(angle * steps / (2*G_PI)) * 2*G_PI / steps;
+    }
+
+    return angle;
+}
+
+static gdouble
+get_hand_angle(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    return quantize_angle(gauge, get_raw_angle(gauge, hand));
+}
+
+static gboolean
+get_hand_area(AgwGauge *gauge, AgwGaugeHand hand, gdouble angle, GdkRectangle *area)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    GtkAllocation room;
+    gint size;
+
+    /* The hand elements are parsed here, the first time they are
+     * really needed */
+    gtk_widget_get_allocation(GTK_WIDGET(gauge), &room);
+    size = MIN(room.width, room.height);
+    if (!agw_gauge_renderer_get_hand_area(priv->renderer, size, hand, angle, area)) {
+        return FALSE;
+    }
+
+    /* Convert the area to widget coordinates */
+    area->x += (room.width - size) / 2;
+    area->y += (room.height - size) / 2;
+    return TRUE;
 }
 
 static void
-free_svg(AgwGaugePrivate *priv)
+size_allocate(GtkWidget *widget, GtkAllocation *allocation)
 {
-    RsvgHandle **svg;
-    gint i;
+    AgwGauge *gauge = AGW_GAUGE(widget);
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+
+    GtkAllocation old;
+
+    gtk_widget_get_allocation(widget, &old);
+    GTK_WIDGET_CLASS(agw_gauge_parent_class)->size_allocate(widget, allocation);
+
+    /* redraw-on-allocate is disabled, so a full redraw must be queued
+     * explicitly when the geometry really changes */
+    if (old.x != allocation->x || old.y != allocation->y ||
+        old.width != allocation->width || old.height != allocation->height) {
+        priv->drawn = FALSE;
+        gtk_widget_queue_draw(widget);
+    }
+}
+
+static void
+scale_factor_changed(GtkWidget *widget, GParamSpec *pspec, gpointer user_data)
+{
+    AgwGauge *gauge = AGW_GAUGE(widget);
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+
+    /* The renderer picks up the new scale from the cairo context */
+    priv->drawn = FALSE;
+}
+
+static void
+queue_hand_redraw(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    GtkWidget *widget = GTK_WIDGET(gauge);
+    AgwGaugeHand hand;
+    GdkRectangle old, new;
+    gdouble angle;
+
+    agw_perf_count(AGW_PERF_REDRAW, gauge);
+
+    if (!priv->drawn) {
+        gtk_widget_queue_draw(widget);
+        return;
+    }
+
+    for (hand = 0; hand < N_HANDS; ++hand) {
+        if (!is_shown(gauge, hand)) {
+            continue;
+        }
+
+        angle = get_hand_angle(gauge, hand);
+        if (angle == priv->hand[hand].drawn_angle) {
+            continue;
+        }
 
-    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
-        svg = priv->svg + i;
-        if (*svg != NULL) {
-            g_object_unref(G_OBJECT(*svg));
-            *svg = NULL;
+        /* Invalidate the old and the new position of the hand */
+        if (!get_hand_area(gauge, hand, priv->hand[hand].drawn_angle, &old) ||
+            !get_hand_area(gauge, hand, angle, &new)) {
+            continue;
         }
+        gdk_rectangle_union(&old, &new, &new);
+        gtk_widget_queue_draw_area(widget, new.x, new.y, new.width, new.height);
     }
 }
 
 static gboolean
-set_theme(AgwGaugePrivate *priv, const gchar *theme_dir, GError **error)
-{
-    gchar *file;
-    RsvgHandle *svg;
-    RsvgDimensionData dimension;
-    gint i;
-
-    priv->width  = 0;
-    priv->height = 0;
-    free_svg(priv);
-
-    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
-        file = g_build_filename(theme_dir, theme_file[i], NULL);
-        svg  = rsvg_handle_new_from_file(file, error);
-        g_free(file);
-
-        /* On errors, return false without further processing */
-        if (svg == NULL) {
-            g_assert(error == NULL || *error != NULL);
-            return FALSE;
+animate(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+    AgwGauge *gauge = AGW_GAUGE(widget);
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    AgwGaugeHandData *data;
+    AgwGaugeHand hand;
+    gint64 frame_time;
+    gdouble delta, elapsed, step;
+    gboolean settled;
+
+    frame_time = gdk_frame_clock_get_frame_time(frame_clock);
+    elapsed = (frame_time - priv->frame_time) / 1000.;
+    priv->frame_time = frame_time;
+    step = 1 - exp(-elapsed / priv->damping);
+    settled = TRUE;
+
+    for (hand = 0; hand < N_HANDS; ++hand) {
+        if (get_adjustment(gauge, hand) == NULL) {
+            continue;
         }
 
-        /* Get the extents of the biggest element */
-        rsvg_handle_get_dimensions(svg, &dimension);
-        priv->width  = MAX(dimension.width, priv->width);
-        priv->height = MAX(dimension.height, priv->height);
+        /* Take the shortest path, also when the value wraps around */
+        data = &priv->hand[hand];
+        delta = remainder(get_target_angle(gauge, hand) - data->shown_angle, 2*G_PI);
+        if (fabs(delta) >= 1e-3) {
+            settled = FALSE;
+        }
+        data->shown_angle += delta * step;
+    }
 
-        priv->svg[i] = svg;
+    if (settled) {
+        /* Stop the animation (and the frame clock wakeups) */
+        priv->tick_id = 0;
+        queue_hand_redraw(gauge);
+        return G_SOURCE_REMOVE;
     }
 
-    return TRUE;
+    queue_hand_redraw(gauge);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+stop_animation(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+
+    if (priv->tick_id != 0) {
+        gtk_widget_remove_tick_callback(GTK_WIDGET(gauge), priv->tick_id);
+        priv->tick_id = 0;
+    }
+}
+
+static void
+hand_moved(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    GtkWidget *widget = GTK_WIDGET(gauge);
+
+    /* Animate only when there is something on screen to move */
+    if (priv->damping > 0 && priv->drawn && gtk_widget_get_mapped(widget)) {
+        if (priv->tick_id == 0) {
+            priv->frame_time = gdk_frame_clock_get_frame_time(gtk_widget_get_frame_clock(widget));
+            priv->tick_id = gtk_widget_add_tick_callback(widget, animate, NULL, NULL);
+        }
+        return;
+    }
+
+    queue_hand_redraw(gauge);
+}
+
+static void
+value_changed(GtkRange *range)
+{
+    hand_moved(AGW_GAUGE(range));
+}
+
+static void
+queue_full_redraw(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    priv->drawn = FALSE;
+    agw_perf_count(AGW_PERF_REDRAW, gauge);
+    gtk_widget_queue_draw(GTK_WIDGET(gauge));
+}
+
+static void
+track_adjustment(AgwGauge *gauge, AgwGaugeHand hand, GtkAdjustment *adjustment)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    AgwGaugeHandData *data = &priv->hand[hand];
+
+    if (adjustment == data->adjustment) {
+        return;
+    }
+
+    /* Handlers are disconnected by id because the same adjustment
+     * could be shared by more hands */
+    if (data->adjustment != NULL) {
+        g_signal_handler_disconnect(data->adjustment, data->changed_id);
+        if (data->value_changed_id != 0) {
+            g_signal_handler_disconnect(data->adjustment, data->value_changed_id);
+        }
+        g_object_unref(data->adjustment);
+    }
+
+    data->adjustment = adjustment;
+    data->changed_id = 0;
+    data->value_changed_id = 0;
+    if (adjustment == NULL) {
+        return;
+    }
+
+    /* Changing the limits of the adjustment moves the hand without
+     * changing the value, so keep an eye on the adjustment in use */
+    g_object_ref_sink(adjustment);
+    data->changed_id = g_signal_connect_swapped(adjustment, "changed",
+                                                G_CALLBACK(queue_full_redraw),
+                                                gauge);
+
+    /* GtkRange already reports the value changes of its adjustment */
+    if (hand != AGW_GAUGE_HAND_MINUTE) {
+        data->value_changed_id = g_signal_connect_swapped(adjustment, "value-changed",
+                                                          G_CALLBACK(hand_moved),
+                                                          gauge);
+    }
+}
+
+static void
+range_notify(AgwGauge *gauge, GParamSpec *pspec, gpointer user_data)
+{
+    track_adjustment(gauge, AGW_GAUGE_HAND_MINUTE,
+                     gtk_range_get_adjustment(GTK_RANGE(gauge)));
+    queue_full_redraw(gauge);
+}
+
+static void
+notify_hand(AgwGauge *gauge, AgwGaugeHand hand, guint hour_prop)
+{
+    /* Hour and second hand properties are laid out in the same order */
+    guint prop = hour_prop;
+
+    if (hand == AGW_GAUGE_HAND_SECOND) {
+        prop += PROP_SECOND_ADJUSTMENT - PROP_HOUR_ADJUSTMENT;
+    }
+    g_object_notify_by_pspec(G_OBJECT(gauge), props[prop]);
+}
+
+static void
+set_theme(AgwGaugePrivate *priv, AgwGaugeTheme *theme)
+{
+    priv->drawn = FALSE;
+    agw_gauge_renderer_take_theme(priv->renderer, theme);
+}
+
+static void
+ensure_theme(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    AgwGaugeTheme *theme;
+    gint64 begin;
+
+    /* Fall back to the default theme only if nothing else has been
+     * set and no theme is being loaded in the background */
+    if (agw_gauge_renderer_peek_theme(priv->renderer) != NULL ||
+        priv->theme_pending > 0) {
+        return;
+    }
+
+    begin = agw_perf_begin();
+    theme = agw_gauge_theme_load(AGW_GAUGE_THEME_DEFAULT, NULL);
+    agw_perf_end(AGW_PERF_THEME_LOAD, gauge, begin, "AgwGauge.set_theme");
+
+    if (theme != NULL) {
+        set_theme(priv, theme);
+    }
+}
+
+static void
+realize(GtkWidget *widget)
+{
+    AgwGauge *gauge = AGW_GAUGE(widget);
+
+    GTK_WIDGET_CLASS(agw_gauge_parent_class)->realize(widget);
+    track_adjustment(gauge, AGW_GAUGE_HAND_MINUTE,
+                     gtk_range_get_adjustment(GTK_RANGE(gauge)));
+    ensure_theme(gauge);
+}
+
+static void
+render(GtkWidget *widget, cairo_t *cr)
+{
+    AgwGauge *gauge = AGW_GAUGE(widget);
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    AgwGaugeRenderer *renderer = priv->renderer;
+    GtkAllocation room;
+    GdkRectangle clip, area;
+    AgwGaugeHand hand;
+    gint size;
+    gdouble raw_angle, angle;
+
+    /* No theme loaded: nothing to draw */
+    ensure_theme(gauge);
+    if (agw_gauge_renderer_peek_theme(renderer) == NULL) {
+        return;
+    }
+
+    gtk_widget_get_allocation(widget, &room);
+    size = MIN(room.width, room.height);
+    if (size <= 0) {
+        return;
+    }
+
+    if (!gdk_cairo_get_clip_rectangle(cr, &clip)) {
+        clip.x = clip.y = 0;
+        clip.width = room.width;
+        clip.height = room.height;
+    }
+
+    cairo_translate(cr, (room.width - size) / 2, (room.height - size) / 2);
+
+    /* Blits are limited by cairo to the clip area, i.e. the region
+     * invalidated by queue_hand_redraw() when only the values changed */
+    agw_gauge_renderer_render_background(renderer, cr, size);
+
+    /* Hands are stacked from hour (bottom) to second (top) and each of
+     * them is drawn only when it is inside the clip area. The hand area
+     * is in widget coordinates, as the clip rectangle. */
+    for (hand = 0; hand < N_HANDS; ++hand) {
+        if (!is_shown(gauge, hand)) {
+            continue;
+        }
+        raw_angle = get_raw_angle(gauge, hand);
+        angle = quantize_angle(gauge, raw_angle);
+        if (!get_hand_area(gauge, hand, angle, &area)) {
+            continue;
+        }
+        if (gdk_rectangle_intersect(&area, &clip, NULL)) {
+            agw_gauge_renderer_render_hand(renderer, cr, size, hand, angle);
+        }
+        priv->hand[hand].drawn_angle = angle;
+        priv->hand[hand].shown_angle = raw_angle;
+    }
+    priv->drawn = TRUE;
+
+    agw_gauge_renderer_render_foreground(renderer, cr, size);
+}
+
+static gboolean
+draw(GtkWidget *widget, cairo_t *cr)
+{
+    gint64 begin = agw_perf_begin();
+
+    render(widget, cr);
+    agw_perf_end(AGW_PERF_DRAW, widget, begin, "AgwGauge.draw");
+
+    return FALSE;
+}
+
+static void
+theme_load_free(AgwGaugeThemeLoad *load)
+{
+    g_free(load->theme_dir);
+    g_free(load);
+}
+
+static void
+load_theme_thread(GTask *task, gpointer source,
+                  gpointer task_data, GCancellable *cancellable)
+{
+    AgwGaugeThemeLoad *load = task_data;
+    AgwGaugeTheme *theme;
+    GError *error;
+    gint64 begin;
+    guint n;
+
+    if (g_task_return_error_if_cancelled(task)) {
+        return;
+    }
+
+    begin = agw_perf_begin();
+    error = NULL;
+    theme = agw_gauge_theme_load(load->theme_dir, &error);
+    if (theme == NULL) {
+        g_task_return_error(task, error);
+        return;
+    }
+
+    /* Parse here the hands in use, so the main thread will not */
+    for (n = 0; n < AGW_GAUGE_THEME_HANDS; ++n) {
+        if (load->hands & (1 << n)) {
+            agw_gauge_theme_load_hand(theme, n);
+        }
+    }
+    agw_perf_end(AGW_PERF_THEME_LOAD, source, begin, "AgwGauge.set_theme");
+
+    g_task_return_pointer(task, theme, (GDestroyNotify) agw_gauge_theme_unref);
+}
+
+static void
+theme_loaded(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    AgwGauge *gauge = AGW_GAUGE(source);
+    AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
+    GTask *task = G_TASK(user_data);
+    AgwGaugeTheme *theme;
+    GError *error;
+
+    --priv->theme_pending;
+
+    error = NULL;
+    theme = g_task_propagate_pointer(G_TASK(result), &error);
+    if (theme == NULL) {
+        g_task_return_error(task, error);
+    } else if (GPOINTER_TO_UINT(g_task_get_task_data(task)) != priv->theme_serial) {
+        /* Another theme has been set in the meantime */
+        agw_gauge_theme_unref(theme);
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                                "The theme has been superseded by a more recent one");
+    } else if (g_task_return_error_if_cancelled(task)) {
+        agw_gauge_theme_unref(theme);
+    } else {
+        set_theme(priv, theme);
+        gtk_widget_queue_draw(GTK_WIDGET(gauge));
+        g_task_return_boolean(task, TRUE);
+    }
+
+    /* Let the default theme kick in if nothing has been loaded */
+    if (agw_gauge_renderer_peek_theme(priv->renderer) == NULL) {
+        gtk_widget_queue_draw(GTK_WIDGET(gauge));
+    }
+
+    g_object_unref(task);
+}
+
+static void
+unmap(GtkWidget *widget)
+{
+    /* Jump to the final position: there is nothing to animate */
+    stop_animation(AGW_GAUGE(widget));
+    GTK_WIDGET_CLASS(agw_gauge_parent_class)->unmap(widget);
 }
 
 static void
@@ -208,7 +700,100 @@ finalize(GObject *object)
 {
     AgwGauge *gauge = AGW_GAUGE(object);
     AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
-    free_svg(priv);
+    AgwGaugeHand hand;
+
+    g_clear_object(&priv->renderer);
+    for (hand = 0; hand < N_HANDS; ++hand) {
+        track_adjustment(gauge, hand, NULL);
+    }
+
+    G_OBJECT_CLASS(agw_gauge_parent_class)->finalize(object);
+}
+
+static void
+get_property(GObject *object, guint prop_id,
+             GValue *value, GParamSpec *pspec)
+{
+    AgwGauge *gauge = AGW_GAUGE(object);
+
+    switch (prop_id) {
+    case PROP_HAND_MODE:
+        g_value_set_enum(value, agw_gauge_get_hand_mode(gauge));
+        break;
+    case PROP_HAND_STEPS:
+        g_value_set_uint(value, agw_gauge_get_hand_steps(gauge));
+        break;
+    case PROP_DAMPING:
+        g_value_set_double(value, agw_gauge_get_damping(gauge));
+        break;
+    case PROP_REVOLUTIONS:
+        g_value_set_int64(value, agw_gauge_get_revolutions(gauge));
+        break;
+    case PROP_HOUR_ADJUSTMENT:
+        g_value_set_object(value, agw_gauge_get_hand_adjustment(gauge, AGW_GAUGE_HAND_HOUR));
+        break;
+    case PROP_HOUR_ORIGIN:
+        g_value_set_double(value, agw_gauge_get_hand_origin(gauge, AGW_GAUGE_HAND_HOUR));
+        break;
+    case PROP_HOUR_INVERTED:
+        g_value_set_boolean(value, agw_gauge_get_hand_inverted(gauge, AGW_GAUGE_HAND_HOUR));
+        break;
+    case PROP_SECOND_ADJUSTMENT:
+        g_value_set_object(value, agw_gauge_get_hand_adjustment(gauge, AGW_GAUGE_HAND_SECOND));
+        break;
+    case PROP_SECOND_ORIGIN:
+        g_value_set_double(value, agw_gauge_get_hand_origin(gauge, AGW_GAUGE_HAND_SECOND));
+        break;
+    case PROP_SECOND_INVERTED:
+        g_value_set_boolean(value, agw_gauge_get_hand_inverted(gauge, AGW_GAUGE_HAND_SECOND));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+set_property(GObject *object, guint prop_id,
+             const GValue *value, GParamSpec *pspec)
+{
+    AgwGauge *gauge = AGW_GAUGE(object);
+
+    switch (prop_id) {
+    case PROP_HAND_MODE:
+        agw_gauge_set_hand_mode(gauge, g_value_get_enum(value));
+        break;
+    case PROP_HAND_STEPS:
+        agw_gauge_set_hand_steps(gauge, g_value_get_uint(value));
+        break;
+    case PROP_DAMPING:
+        agw_gauge_set_damping(gauge, g_value_get_double(value));
+        break;
+    case PROP_REVOLUTIONS:
+        agw_gauge_set_revolutions(gauge, g_value_get_int64(value));
+        break;
+    case PROP_HOUR_ADJUSTMENT:
+        agw_gauge_set_hand_adjustment(gauge, AGW_GAUGE_HAND_HOUR, g_value_get_object(value));
+        break;
+    case PROP_HOUR_ORIGIN:
+        agw_gauge_set_hand_origin(gauge, AGW_GAUGE_HAND_HOUR, g_value_get_double(value));
+        break;
+    case PROP_HOUR_INVERTED:
+        agw_gauge_set_hand_inverted(gauge, AGW_GAUGE_HAND_HOUR, g_value_get_boolean(value));
+        break;
+    case PROP_SECOND_ADJUSTMENT:
+        agw_gauge_set_hand_adjustment(gauge, AGW_GAUGE_HAND_SECOND, g_value_get_object(value));
+        break;
+    case PROP_SECOND_ORIGIN:
+        agw_gauge_set_hand_origin(gauge, AGW_GAUGE_HAND_SECOND, g_value_get_double(value));
+        break;
+    case PROP_SECOND_INVERTED:
+        agw_gauge_set_hand_inverted(gauge, AGW_GAUGE_HAND_SECOND, g_value_get_boolean(value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
 }
 
 static void
@@ -216,31 +801,132 @@ agw_gauge_class_init(AgwGaugeClass *class)
 {
     GObjectClass *object_class = G_OBJECT_CLASS(class);
     GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(class);
+    GtkRangeClass *range_class = GTK_RANGE_CLASS(class);
 
     object_class->finalize = finalize;
+    object_class->get_property = get_property;
+    object_class->set_property = set_property;
 
     widget_class->get_preferred_width = get_preferred_width_or_height;
     widget_class->get_preferred_height = get_preferred_width_or_height;
+    widget_class->realize = realize;
+    widget_class->unmap = unmap;
+    widget_class->size_allocate = size_allocate;
     widget_class->draw = draw;
+
+    range_class->value_changed = value_changed;
+
+    props[PROP_HAND_MODE] = g_param_spec_enum("hand-mode",
+                                              "Hand Mode",
+                                              "How the hand is rendered",
+                                              AGW_TYPE_GAUGE_HAND_MODE,
+                                              AGW_GAUGE_HAND_MODE_VECTOR,
+                                              G_PARAM_READWRITE);
+    props[PROP_HAND_STEPS] = g_param_spec_uint("hand-steps",
+                                               "Hand Steps",
+                                               "Number of pre-rotated hand sprites in atlas mode",
+                                               2, 3600, 120,
+                                               G_PARAM_READWRITE);
+    props[PROP_DAMPING] = g_param_spec_double("damping",
+                                              "Damping",
+                                              "Time constant of the hand animation in milliseconds, 0 to disable it",
+                                              0, G_MAXDOUBLE, 0,
+                                              G_PARAM_READWRITE);
+    props[PROP_REVOLUTIONS] = g_param_spec_int64("revolutions",
+                                                 "Revolutions",
+                                                 "Whole turns of the value set by agw_gauge_set_value()",
+                                                 G_MININT64, G_MAXINT64, 0,
+                                                 G_PARAM_READWRITE);
+    props[PROP_HOUR_ADJUSTMENT] = g_param_spec_object("hour-adjustment",
+                                                      "Hour Adjustment",
+                                                      "The adjustment driving the hour hand, NULL to hide it",
+                                                      GTK_TYPE_ADJUSTMENT,
+                                                      G_PARAM_READWRITE);
+    props[PROP_HOUR_ORIGIN] = g_param_spec_double("hour-origin",
+                                                  "Hour Origin",
+                                                  "Angle of the hour hand at 0, in radians",
+                                                  -G_MAXDOUBLE, G_MAXDOUBLE, -G_PI_2,
+                                                  G_PARAM_READWRITE);
+    props[PROP_HOUR_INVERTED] = g_param_spec_boolean("hour-inverted",
+                                                     "Hour Inverted",
+                                                     "Whether the hour hand turns counterclockwise",
+                                                     FALSE,
+                                                     G_PARAM_READWRITE);
+    props[PROP_SECOND_ADJUSTMENT] = g_param_spec_object("second-adjustment",
+                                                        "Second Adjustment",
+                                                        "The adjustment driving the second hand, NULL to hide it",
+                                                        GTK_TYPE_ADJUSTMENT,
+                                                        G_PARAM_READWRITE);
+    props[PROP_SECOND_ORIGIN] = g_param_spec_double("second-origin",
+                                                    "Second Origin",
+                                                    "Angle of the second hand at 0, in radians",
+                                                    -G_MAXDOUBLE, G_MAXDOUBLE, -G_PI_2,
+                                                    G_PARAM_READWRITE);
+    props[PROP_SECOND_INVERTED] = g_param_spec_boolean("second-inverted",
+                                                       "Second Inverted",
+                                                       "Whether the second hand turns counterclockwise",
+                                                       FALSE,
+                                                       G_PARAM_READWRITE);
+
+    g_object_class_install_properties(object_class, NUM_PROPERTIES, props);
+
+    /**
+     * AgwGauge::wrapped:
+     * @gauge: the object which received the signal
+     * @turns: whole turns crossed, negative when going backward
+     *
+     * Emitted by agw_gauge_set_value() when the new value is on a
+     * different turn than the previous one, i.e. when the
+     * #AgwGauge:revolutions property changes because of wrapping.
+     **/
+    signals[WRAPPED] = g_signal_new("wrapped",
+                                    G_TYPE_FROM_CLASS(class),
+                                    G_SIGNAL_RUN_LAST,
+                                    0, NULL, NULL, NULL,
+                                    G_TYPE_NONE, 1, G_TYPE_INT64);
 }
 
 static void
 agw_gauge_init(AgwGauge *gauge)
 {
     AgwGaugePrivate *priv = agw_gauge_get_instance_private(gauge);
-    gchar *theme;
-    gint i;
+    AgwGaugeHandData *data;
+    AgwGaugeHand hand;
 
     gtk_widget_set_has_window(GTK_WIDGET(gauge), FALSE);
+    gtk_widget_set_redraw_on_allocate(GTK_WIDGET(gauge), FALSE);
     gtk_range_set_fill_level(GTK_RANGE(gauge), -G_PI_2);
+    g_signal_connect(gauge, "notify::scale-factor",
+                     G_CALLBACK(scale_factor_changed), NULL);
+    g_signal_connect(gauge, "notify::adjustment",
+                     G_CALLBACK(range_notify), NULL);
+    g_signal_connect(gauge, "notify::inverted",
+                     G_CALLBACK(range_notify), NULL);
+    g_signal_connect(gauge, "notify::fill-level",
+                     G_CALLBACK(range_notify), NULL);
 
-    /* Set the default theme */
-    for (i = 0; i < AGW_GAUGE_ELEMENT_LAST; ++i) {
-        priv->svg[i] = NULL;
+    priv->renderer      = agw_gauge_renderer_new();
+    priv->theme_serial  = 0;
+    priv->theme_pending = 0;
+    priv->drawn         = FALSE;
+    priv->damping       = 0;
+    priv->tick_id       = 0;
+    priv->frame_time    = 0;
+    priv->revolutions   = 0;
+
+    /* Only the minute hand (bound to the GtkRange) is shown by default */
+    for (hand = 0; hand < N_HANDS; ++hand) {
+        data = &priv->hand[hand];
+        data->adjustment        = NULL;
+        data->changed_id        = 0;
+        data->value_changed_id  = 0;
+        data->origin            = -G_PI_2;
+        data->inverted          = FALSE;
+        data->drawn_angle       = 0;
+        data->shown_angle       = 0;
     }
-    theme = g_build_filename(PKGDATADIR, "assets", NULL);
-    set_theme(priv, theme, NULL);
-    g_free(theme);
+
+    /* The default theme is loaded lazily by ensure_theme() */
 }
 
 
@@ -270,19 +956,126 @@ agw_gauge_new(void)
  * compatible with the [cairo-clock](https://launchpad.net/cairo-clock)
  * project, so any cairo-clock theme can be used.
  *
+ * Themes embedded in the application as GResource can be used by
+ * passing their `resource://` URI, e.g. `resource:///org/entidi/agw/assets`
+ * for the default theme: no filesystem access is involved then.
+ *
+ * @theme_dir can also be a theme pack generated by the
+ * `agw-theme-compile` tool. A pack is memory mapped and its layers and
+ * hand sprites, already rasterized at the sizes chosen when compiling
+ * it, are painted directly: the SVG sources it contains are parsed
+ * only for the other sizes and for %AGW_GAUGE_HAND_MODE_VECTOR and
+ * %AGW_GAUGE_HAND_MODE_ATLAS hands.
+ *
+ * Themes are cached process-wide: gauges using the same theme share
+ * the parsed SVG documents and, when they have the same size, the
+ * rasterized layers too. If the theme cannot be loaded, the previous
+ * theme is kept.
+ *
+ * Any pending agw_gauge_set_theme_async() call is superseded.
+ *
  * @return: TRUE if the theme has been succesfully changed.
  **/
 gboolean
 agw_gauge_set_theme(AgwGauge *gauge, const gchar *theme_dir, GError **error)
 {
     AgwGaugePrivate *priv;
+    AgwGaugeTheme *theme;
+    gint64 begin;
 
     g_return_val_if_fail(AGW_IS_GAUGE(gauge), FALSE);
     g_return_val_if_fail(theme_dir != NULL, FALSE);
     g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
     priv = agw_gauge_get_instance_private(gauge);
-    return set_theme(priv, theme_dir, error);
+    ++priv->theme_serial;
+
+    /* On errors, keep the old theme */
+    begin = agw_perf_begin();
+    theme = agw_gauge_theme_load(theme_dir, error);
+    agw_perf_end(AGW_PERF_THEME_LOAD, gauge, begin, "AgwGauge.set_theme");
+    if (theme == NULL) {
+        return FALSE;
+    }
+
+    set_theme(priv, theme);
+    gtk_widget_queue_draw(GTK_WIDGET(gauge));
+    return TRUE;
+}
+
+/**
+ * agw_gauge_set_theme_async:
+ * @gauge: an #AgwGauge
+ * @theme_dir: path to the new theme
+ * @cancellable: (allow-none): optional #GCancellable object, %NULL to ignore
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the
+ *            theme has been set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of agw_gauge_set_theme(). The theme is parsed
+ * on a worker thread while the current theme stays on screen; once
+ * ready, it is swapped in from the main context before calling
+ * @callback. If another theme is set before this one is ready, this
+ * call fails with %G_IO_ERROR_CANCELLED.
+ *
+ * Call agw_gauge_set_theme_finish() from @callback to get the result.
+ **/
+void
+agw_gauge_set_theme_async(AgwGauge *gauge, const gchar *theme_dir,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback, gpointer user_data)
+{
+    AgwGaugePrivate *priv;
+    AgwGaugeThemeLoad *data;
+    AgwGaugeHand hand;
+    GTask *task, *load;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail(theme_dir != NULL);
+    g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+
+    priv = agw_gauge_get_instance_private(gauge);
+    ++priv->theme_serial;
+    ++priv->theme_pending;
+
+    task = g_task_new(gauge, cancellable, callback, user_data);
+    g_task_set_source_tag(task, agw_gauge_set_theme_async);
+    g_task_set_task_data(task, GUINT_TO_POINTER(priv->theme_serial), NULL);
+
+    /* The theme is loaded by an inner task, so it can be swapped in
+     * before the caller is notified */
+    data = g_new(AgwGaugeThemeLoad, 1);
+    data->theme_dir = g_strdup(theme_dir);
+    data->hands = 0;
+    for (hand = 0; hand < N_HANDS; ++hand) {
+        if (get_adjustment(gauge, hand) != NULL) {
+            data->hands |= 1 << hand;
+        }
+    }
+
+    load = g_task_new(gauge, cancellable, theme_loaded, task);
+    g_task_set_task_data(load, data, (GDestroyNotify) theme_load_free);
+    g_task_run_in_thread(load, load_theme_thread);
+    g_object_unref(load);
+}
+
+/**
+ * agw_gauge_set_theme_finish:
+ * @gauge: an #AgwGauge
+ * @result: the #GAsyncResult passed to the callback
+ * @error: (allow-none): return location for a #GError, or %NULL
+ *
+ * Finishes an operation started with agw_gauge_set_theme_async().
+ *
+ * @return: TRUE if the theme has been succesfully changed.
+ **/
+gboolean
+agw_gauge_set_theme_finish(AgwGauge *gauge, GAsyncResult *result, GError **error)
+{
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), FALSE);
+    g_return_val_if_fail(g_task_is_valid(result, gauge), FALSE);
+
+    return g_task_propagate_boolean(G_TASK(result), error);
 }
 
 /**
@@ -294,25 +1087,392 @@ agw_gauge_set_theme(AgwGauge *gauge, const gchar *theme_dir, GError **error)
  * minimum or maximum range values, it will be wrapped around to fit
  * inside them. The gauge emits the #AgwGauge::value-changed signal if
  * the value changes.
+ *
+ * Wrapping takes constant time, whatever the distance from the limits,
+ * and the number of whole turns is stored in the
+ * #AgwGauge:revolutions property: when it changes, the
+ * #AgwGauge::wrapped signal is emitted. For a gauge spanning 0..N,
+ * feeding a raw counter gives revolutions = floor(value / N). Integral
+ * values are handled exactly up to 2^53. @value must be finite.
  **/
 void
 agw_gauge_set_value(AgwGauge *gauge, gdouble value)
 {
+    AgwGaugePrivate *priv;
     GtkAdjustment *adjustment;
-    gdouble lower, upper;
+    gdouble lower, span, offset, quotient;
+    gint64 turns;
 
     g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail(isfinite(value));
 
+    priv = agw_gauge_get_instance_private(gauge);
     adjustment = gtk_range_get_adjustment(GTK_RANGE(gauge));
     lower = gtk_adjustment_get_lower(adjustment);
-    upper = gtk_adjustment_get_upper(adjustment);
+    span = gtk_adjustment_get_upper(adjustment) - lower;
+
+    if (span <= 0) {
+        gtk_adjustment_set_value(adjustment, value);
+        return;
+    }
+
+    /* fmod() is exact, so `value - lower - offset` is an exact multiple
+     * of `span` and the division below only needs rounding */
+    offset = fmod(value - lower, span);
+    if (offset < 0) {
+        offset += span;
+    }
+    if (offset >= span) {
+        /* A tiny negative offset rounded up to `span` */
+        offset = 0;
+    }
+    /* Casting an out of range double is undefined behavior: half the
+     * gint64 range also keeps the `delta` below from overflowing */
+    quotient = floor((value - lower - offset) / span + 0.5);
+    turns = (gint64) CLAMP(quotient, G_MININT64 / 2, G_MAXINT64 / 2);
 
-    while (value < lower) {
-        value += upper - lower;
+    gtk_adjustment_set_value(adjustment, lower + offset);
+
+    if (turns != priv->revolutions) {
+        gint64 delta = turns - priv->revolutions;
+        priv->revolutions = turns;
+        g_object_notify_by_pspec(G_OBJECT(gauge), props[PROP_REVOLUTIONS]);
+        g_signal_emit(gauge, signals[WRAPPED], 0, delta);
     }
-    while (value >= upper) {
-        value -= upper - lower;
+}
+
+/**
+ * agw_gauge_set_revolutions:
+ * @gauge: an #AgwGauge
+ * @revolutions: the new number of whole turns
+ *
+ * Overrides the number of whole turns, e.g. to reset it to 0 after
+ * homing. Later calls to agw_gauge_set_value() will overwrite it.
+ **/
+void
+agw_gauge_set_revolutions(AgwGauge *gauge, gint64 revolutions)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+
+    priv = agw_gauge_get_instance_private(gauge);
+    if (revolutions != priv->revolutions) {
+        priv->revolutions = revolutions;
+        g_object_notify_by_pspec(G_OBJECT(gauge), props[PROP_REVOLUTIONS]);
+    }
+}
+
+/**
+ * agw_gauge_get_revolutions:
+ * @gauge: an #AgwGauge
+ *
+ * Gets the number of whole turns of the last value set with
+ * agw_gauge_set_value().
+ *
+ * @return: the number of revolutions, negative below the lower limit
+ **/
+gint64
+agw_gauge_get_revolutions(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), 0);
+
+    priv = agw_gauge_get_instance_private(gauge);
+    return priv->revolutions;
+}
+
+/**
+ * agw_gauge_set_hand_mode:
+ * @gauge: an #AgwGauge
+ * @mode: the new #AgwGaugeHandMode
+ *
+ * Sets how the hand of @gauge is rendered. The bitmap and atlas modes
+ * trade some memory (and, for the atlas, some angular precision) for
+ * a per-frame cost that does not depend on the complexity of the
+ * theme.
+ **/
+void
+agw_gauge_set_hand_mode(AgwGauge *gauge, AgwGaugeHandMode mode)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+
+    priv = agw_gauge_get_instance_private(gauge);
+    if (mode != agw_gauge_renderer_get_hand_mode(priv->renderer)) {
+        agw_gauge_renderer_set_hand_mode(priv->renderer, mode);
+        g_object_notify_by_pspec(G_OBJECT(gauge), props[PROP_HAND_MODE]);
+        gtk_widget_queue_draw(GTK_WIDGET(gauge));
     }
+}
+
+/**
+ * agw_gauge_get_hand_mode:
+ * @gauge: an #AgwGauge
+ *
+ * Gets how the hand of @gauge is rendered.
+ *
+ * @return: the current #AgwGaugeHandMode
+ **/
+AgwGaugeHandMode
+agw_gauge_get_hand_mode(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), AGW_GAUGE_HAND_MODE_VECTOR);
+
+    priv = agw_gauge_get_instance_private(gauge);
+    return agw_gauge_renderer_get_hand_mode(priv->renderer);
+}
+
+/**
+ * agw_gauge_set_hand_steps:
+ * @gauge: an #AgwGauge
+ * @steps: number of sprites in a full turn
+ *
+ * Sets the angular resolution of the hand atlas, i.e. how many
+ * pre-rotated sprites cover a full turn. Only meaningful when the hand
+ * mode is %AGW_GAUGE_HAND_MODE_ATLAS. Sprites are rasterized on first
+ * use, so memory grows only with the angles actually shown.
+ **/
+void
+agw_gauge_set_hand_steps(AgwGauge *gauge, guint steps)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail(steps >= 2);
+
+    priv = agw_gauge_get_instance_private(gauge);
+    if (steps != agw_gauge_renderer_get_hand_steps(priv->renderer)) {
+        agw_gauge_renderer_set_hand_steps(priv->renderer, steps);
+        g_object_notify_by_pspec(G_OBJECT(gauge), props[PROP_HAND_STEPS]);
+        gtk_widget_queue_draw(GTK_WIDGET(gauge));
+    }
+}
+
+/**
+ * agw_gauge_get_hand_steps:
+ * @gauge: an #AgwGauge
+ *
+ * Gets the angular resolution of the hand atlas.
+ *
+ * @return: the number of sprites in a full turn
+ **/
+guint
+agw_gauge_get_hand_steps(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), 0);
+
+    priv = agw_gauge_get_instance_private(gauge);
+    return agw_gauge_renderer_get_hand_steps(priv->renderer);
+}
+
+/**
+ * agw_gauge_set_damping:
+ * @gauge: an #AgwGauge
+ * @damping: time constant in milliseconds, or 0
+ *
+ * Sets the time constant of the hand animation. When greater than 0,
+ * the hand does not jump to the new value but approaches it
+ * exponentially: after @damping milliseconds it has covered about 63%
+ * of the way. Set it to 0 (the default) to disable the animation.
+ **/
+void
+agw_gauge_set_damping(AgwGauge *gauge, gdouble damping)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail(damping >= 0);
+
+    priv = agw_gauge_get_instance_private(gauge);
+    if (damping != priv->damping) {
+        priv->damping = damping;
+        if (damping == 0 && priv->tick_id != 0) {
+            stop_animation(gauge);
+            queue_hand_redraw(gauge);
+        }
+        g_object_notify_by_pspec(G_OBJECT(gauge), props[PROP_DAMPING]);
+    }
+}
+
+/**
+ * agw_gauge_get_damping:
+ * @gauge: an #AgwGauge
+ *
+ * Gets the time constant of the hand animation.
+ *
+ * @return: the time constant in milliseconds, 0 if disabled
+ **/
+gdouble
+agw_gauge_get_damping(AgwGauge *gauge)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), 0);
+
+    priv = agw_gauge_get_instance_private(gauge);
+    return priv->damping;
+}
+
+/**
+ * agw_gauge_set_hand_adjustment:
+ * @gauge: an #AgwGauge
+ * @hand: the #AgwGaugeHand to change
+ * @adjustment: (allow-none): the new #GtkAdjustment, or %NULL
+ *
+ * Sets the adjustment driving @hand. The hour and second hands are
+ * shown only when they have an adjustment, so pass %NULL to hide
+ * them. For %AGW_GAUGE_HAND_MINUTE this is the same as calling
+ * gtk_range_set_adjustment(): that hand is always shown.
+ *
+ * The angle of the hand is computed from @adjustment exactly as for
+ * the minute hand, i.e. a full turn spans its lower to upper range.
+ **/
+void
+agw_gauge_set_hand_adjustment(AgwGauge *gauge, AgwGaugeHand hand,
+                              GtkAdjustment *adjustment)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail((guint) hand < N_HANDS);
+    g_return_if_fail(adjustment == NULL || GTK_IS_ADJUSTMENT(adjustment));
+
+    if (hand == AGW_GAUGE_HAND_MINUTE) {
+        gtk_range_set_adjustment(GTK_RANGE(gauge), adjustment);
+        return;
+    }
+
+    priv = agw_gauge_get_instance_private(gauge);
+    if (adjustment != priv->hand[hand].adjustment) {
+        track_adjustment(gauge, hand, adjustment);
+        if (adjustment != NULL) {
+            /* A new hand appears where it is, without animations */
+            priv->hand[hand].shown_angle = get_target_angle(gauge, hand);
+        }
+        queue_full_redraw(gauge);
+        notify_hand(gauge, hand, PROP_HOUR_ADJUSTMENT);
+    }
+}
+
+/**
+ * agw_gauge_get_hand_adjustment:
+ * @gauge: an #AgwGauge
+ * @hand: an #AgwGaugeHand
+ *
+ * Gets the adjustment driving @hand.
+ *
+ * @return: (transfer none): the #GtkAdjustment or %NULL if @hand is hidden
+ **/
+GtkAdjustment *
+agw_gauge_get_hand_adjustment(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), NULL);
+    g_return_val_if_fail((guint) hand < N_HANDS, NULL);
+
+    return get_adjustment(gauge, hand);
+}
+
+/**
+ * agw_gauge_set_hand_origin:
+ * @gauge: an #AgwGauge
+ * @hand: the #AgwGaugeHand to change
+ * @origin: angle of the hand at 0, in radians
+ *
+ * Sets the position of @hand when its value is 0. The default is
+ * `-G_PI_2`, i.e. north. For %AGW_GAUGE_HAND_MINUTE this is the same
+ * as setting the `fill-level` property.
+ **/
+void
+agw_gauge_set_hand_origin(AgwGauge *gauge, AgwGaugeHand hand, gdouble origin)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail((guint) hand < N_HANDS);
+
+    if (hand == AGW_GAUGE_HAND_MINUTE) {
+        gtk_range_set_fill_level(GTK_RANGE(gauge), origin);
+        return;
+    }
+
+    priv = agw_gauge_get_instance_private(gauge);
+    if (origin != priv->hand[hand].origin) {
+        priv->hand[hand].origin = origin;
+        queue_full_redraw(gauge);
+        notify_hand(gauge, hand, PROP_HOUR_ORIGIN);
+    }
+}
+
+/**
+ * agw_gauge_get_hand_origin:
+ * @gauge: an #AgwGauge
+ * @hand: an #AgwGaugeHand
+ *
+ * Gets the position of @hand when its value is 0.
+ *
+ * @return: the origin angle, in radians
+ **/
+gdouble
+agw_gauge_get_hand_origin(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), 0);
+    g_return_val_if_fail((guint) hand < N_HANDS, 0);
+
+    return get_origin(gauge, hand);
+}
+
+/**
+ * agw_gauge_set_hand_inverted:
+ * @gauge: an #AgwGauge
+ * @hand: the #AgwGaugeHand to change
+ * @inverted: %TRUE to turn @hand counterclockwise
+ *
+ * Sets the direction of @hand. For %AGW_GAUGE_HAND_MINUTE this is the
+ * same as calling gtk_range_set_inverted().
+ **/
+void
+agw_gauge_set_hand_inverted(AgwGauge *gauge, AgwGaugeHand hand, gboolean inverted)
+{
+    AgwGaugePrivate *priv;
+
+    g_return_if_fail(AGW_IS_GAUGE(gauge));
+    g_return_if_fail((guint) hand < N_HANDS);
+
+    if (hand == AGW_GAUGE_HAND_MINUTE) {
+        gtk_range_set_inverted(GTK_RANGE(gauge), inverted);
+        return;
+    }
+
+    priv = agw_gauge_get_instance_private(gauge);
+    inverted = inverted != FALSE;
+    if (inverted != priv->hand[hand].inverted) {
+        priv->hand[hand].inverted = inverted;
+        queue_full_redraw(gauge);
+        notify_hand(gauge, hand, PROP_HOUR_INVERTED);
+    }
+}
+
+/**
+ * agw_gauge_get_hand_inverted:
+ * @gauge: an #AgwGauge
+ * @hand: an #AgwGaugeHand
+ *
+ * Gets the direction of @hand.
+ *
+ * @return: %TRUE if @hand turns counterclockwise
+ **/
+gboolean
+agw_gauge_get_hand_inverted(AgwGauge *gauge, AgwGaugeHand hand)
+{
+    g_return_val_if_fail(AGW_IS_GAUGE(gauge), FALSE);
+    g_return_val_if_fail((guint) hand < N_HANDS, FALSE);
 
-    gtk_adjustment_set_value(adjustment, value);
+    return get_inverted(gauge, hand);
 }
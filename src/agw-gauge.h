@@ -20,6 +20,7 @@
 #define __AGW_GAUGE_H__
 
 #include <gtk/gtk.h>
+#include "agw-gauge-renderer.h"
 
 
 G_BEGIN_DECLS
@@ -33,8 +34,46 @@ GtkWidget *     agw_gauge_new               (void);
 gboolean        agw_gauge_set_theme         (AgwGauge *     gauge,
                                              const gchar *  theme_dir,
                                              GError **      error);
+void            agw_gauge_set_theme_async   (AgwGauge *     gauge,
+                                             const gchar *  theme_dir,
+                                             GCancellable * cancellable,
+                                             GAsyncReadyCallback callback,
+                                             gpointer       user_data);
+gboolean        agw_gauge_set_theme_finish  (AgwGauge *     gauge,
+                                             GAsyncResult * result,
+                                             GError **      error);
 void            agw_gauge_set_value         (AgwGauge *     gauge,
                                              gdouble        value);
+void            agw_gauge_set_revolutions   (AgwGauge *     gauge,
+                                             gint64         revolutions);
+gint64          agw_gauge_get_revolutions   (AgwGauge *     gauge);
+void            agw_gauge_set_hand_mode     (AgwGauge *     gauge,
+                                             AgwGaugeHandMode mode);
+AgwGaugeHandMode
+                agw_gauge_get_hand_mode     (AgwGauge *     gauge);
+void            agw_gauge_set_hand_steps    (AgwGauge *     gauge,
+                                             guint          steps);
+guint           agw_gauge_get_hand_steps    (AgwGauge *     gauge);
+void            agw_gauge_set_damping       (AgwGauge *     gauge,
+                                             gdouble        damping);
+gdouble         agw_gauge_get_damping       (AgwGauge *     gauge);
+void            agw_gauge_set_hand_adjustment
+                                            (AgwGauge *     gauge,
+                                             AgwGaugeHand   hand,
+                                             GtkAdjustment *adjustment);
+GtkAdjustment * agw_gauge_get_hand_adjustment
+                                            (AgwGauge *     gauge,
+                                             AgwGaugeHand   hand);
+void            agw_gauge_set_hand_origin   (AgwGauge *     gauge,
+                                             AgwGaugeHand   hand,
+                                             gdouble        origin);
+gdouble         agw_gauge_get_hand_origin   (AgwGauge *     gauge,
+                                             AgwGaugeHand   hand);
+void            agw_gauge_set_hand_inverted (AgwGauge *     gauge,
+                                             AgwGaugeHand   hand,
+                                             gboolean       inverted);
+gboolean        agw_gauge_get_hand_inverted (AgwGauge *     gauge,
+                                             AgwGaugeHand   hand);
 
 G_END_DECLS
 
@@ -0,0 +1,171 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Cache of the glyphs used by numeric text.
+ *
+ * Every character is shaped alone, with the font and the attributes of
+ * the layout it comes from: a character is cached only if it maps to a
+ * single glyph of the same font used by the others, with no offsets.
+ * Text is then converted to glyphs by looking up its characters, with
+ * no itemization nor shaping, so it must be composed only of characters
+ * that do not interact with each other (no ligatures, no kerning): this
+ * holds for numbers rendered with tabular digits.
+ */
+
+#include "agw-glyph-cache.h"
+
+
+/*
+ * agw_glyph_cache_new:
+ * @layout: a layout with the font and the attributes to use
+ * @charset: the characters to cache
+ *
+ * Shapes every ASCII character of @charset with the settings of
+ * @layout. The text of @layout is changed in the process.
+ *
+ * Returns: the new cache, to be freed with agw_glyph_cache_free(), or
+ *          %NULL if no glyph can be cached (e.g. a non-cairo font)
+ */
+AgwGlyphCache *
+agw_glyph_cache_new(PangoLayout *layout, const gchar *charset)
+{
+    AgwGlyphCache *cache;
+    PangoFont *font;
+    PangoLayoutLine *line;
+    PangoLayoutRun *run;
+    PangoGlyphInfo *info;
+    const gchar *p;
+    guchar ch;
+    gboolean empty;
+
+    g_return_val_if_fail(PANGO_IS_LAYOUT(layout), NULL);
+    g_return_val_if_fail(charset != NULL, NULL);
+
+    cache = g_new0(AgwGlyphCache, 1);
+    font = NULL;
+    empty = TRUE;
+
+    for (p = charset; *p != '\0'; ++p) {
+        ch = *p;
+        if (ch >= AGW_GLYPH_CACHE_SIZE || cache->cached[ch]) {
+            continue;
+        }
+
+        pango_layout_set_text(layout, p, 1);
+        line = pango_layout_get_line_readonly(layout, 0);
+        if (line == NULL || line->runs == NULL || line->runs->next != NULL) {
+            continue;
+        }
+
+        run = line->runs->data;
+        if (run->glyphs->num_glyphs != 1) {
+            continue;
+        }
+        info = &run->glyphs->glyphs[0];
+        if ((info->glyph & PANGO_GLYPH_UNKNOWN_FLAG) != 0 ||
+            info->glyph == PANGO_GLYPH_EMPTY ||
+            info->geometry.x_offset != 0 || info->geometry.y_offset != 0) {
+            continue;
+        }
+
+        if (font == NULL) {
+            /* The first glyph picks the font (fonts are shared by pango,
+             * so the other glyphs can be checked by pointer) */
+            font = run->item->analysis.font;
+            if (!PANGO_IS_CAIRO_FONT(font)) {
+                break;
+            }
+            cache->scaled_font = pango_cairo_font_get_scaled_font(PANGO_CAIRO_FONT(font));
+            if (cache->scaled_font == NULL) {
+                break;
+            }
+            cairo_scaled_font_reference(cache->scaled_font);
+            cache->baseline = pango_units_to_double(pango_layout_get_baseline(layout));
+        } else if (run->item->analysis.font != font) {
+            /* A fallback font */
+            continue;
+        }
+
+        cache->cached[ch] = TRUE;
+        cache->glyph[ch] = info->glyph;
+        cache->advance[ch] = pango_units_to_double(info->geometry.width);
+        empty = FALSE;
+    }
+
+    if (empty) {
+        agw_glyph_cache_free(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+void
+agw_glyph_cache_free(AgwGlyphCache *cache)
+{
+    if (cache != NULL) {
+        if (cache->scaled_font != NULL) {
+            cairo_scaled_font_destroy(cache->scaled_font);
+        }
+        g_free(cache);
+    }
+}
+
+/*
+ * agw_glyph_cache_map:
+ * @cache: an #AgwGlyphCache
+ * @text: the text to convert
+ * @glyphs: where to store the glyphs
+ * @size: number of elements of @glyphs
+ * @n_glyphs: where to store the number of glyphs
+ * @width: where to store the width of @text, in pixels
+ *
+ * Converts @text into glyphs positioned on the baseline, starting at 0.
+ *
+ * Returns: %TRUE on success, %FALSE if @text contains characters not
+ *          in @cache or does not fit in @glyphs
+ */
+gboolean
+agw_glyph_cache_map(const AgwGlyphCache *cache, const gchar *text,
+                    cairo_glyph_t *glyphs, gsize size,
+                    gint *n_glyphs, gdouble *width)
+{
+    const gchar *p;
+    gdouble x;
+    guchar ch;
+    gsize n;
+
+    x = 0;
+    n = 0;
+    for (p = text; *p != '\0'; ++p) {
+        ch = *p;
+        if (ch >= AGW_GLYPH_CACHE_SIZE || !cache->cached[ch] || n >= size) {
+            return FALSE;
+        }
+        glyphs[n].index = cache->glyph[ch];
+        glyphs[n].x = x;
+        glyphs[n].y = 0;
+        x += cache->advance[ch];
+        ++n;
+    }
+
+    *n_glyphs = n;
+    *width = x;
+    return TRUE;
+}
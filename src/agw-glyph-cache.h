@@ -0,0 +1,59 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Private header: not installed and not part of the public API */
+
+#ifndef __AGW_GLYPH_CACHE_H__
+#define __AGW_GLYPH_CACHE_H__
+
+#include <pango/pangocairo.h>
+
+
+G_BEGIN_DECLS
+
+/* Only ASCII characters are cached */
+#define AGW_GLYPH_CACHE_SIZE    128
+
+typedef struct _AgwGlyphCache AgwGlyphCache;
+
+/* The glyphs of a small character set, shaped once with a given font,
+ * so text made only of them can be drawn with cairo_show_glyphs() */
+struct _AgwGlyphCache {
+    cairo_scaled_font_t *scaled_font;
+    /* Distance of the baseline from the top of the text, in pixels */
+    gdouble     baseline;
+    gboolean    cached[AGW_GLYPH_CACHE_SIZE];
+    gulong      glyph[AGW_GLYPH_CACHE_SIZE];
+    /* In pixels */
+    gdouble     advance[AGW_GLYPH_CACHE_SIZE];
+};
+
+AgwGlyphCache * agw_glyph_cache_new     (PangoLayout *      layout,
+                                         const gchar *      charset);
+void            agw_glyph_cache_free    (AgwGlyphCache *    cache);
+gboolean        agw_glyph_cache_map     (const AgwGlyphCache *cache,
+                                         const gchar *      text,
+                                         cairo_glyph_t *    glyphs,
+                                         gsize              size,
+                                         gint *             n_glyphs,
+                                         gdouble *          width);
+
+G_END_DECLS
+
+
+#endif /* __AGW_GLYPH_CACHE_H__ */
@@ -0,0 +1,499 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Formatting of a double value with a printf-style format.
+ *
+ * The format is parsed and validated once: it can contain literal text,
+ * `%%` and at most one floating point conversion with optional flags,
+ * width and precision. The common `%f` and `%g` cases with a small
+ * precision are then formatted by integer arithmetic; everything else
+ * (`%e`, `%a`, grouping and the values falling too close to a rounding
+ * tie) goes through g_snprintf() with the conversion alone, so the
+ * result is always the same as printf().
+ */
+
+#include "agw-numeric-format.h"
+#include <locale.h>
+#include <math.h>
+#include <string.h>
+
+#define MAX_WIDTH       64
+#define MAX_PRECISION   64
+#define MAX_FAST_DIGITS 9
+/* Below this, the scaled value is known with an error much smaller than
+ * the tie window */
+#define MAX_FAST_SCALED 1e12
+#define TIE_WINDOW      1e-3
+/* Powers of 10 up to this are exact as doubles (and fit in a guint64) */
+#define MAX_POW10       19
+
+
+static const guint64 pow10[MAX_POW10 + 1] = {
+    G_GUINT64_CONSTANT(1),
+    G_GUINT64_CONSTANT(10),
+    G_GUINT64_CONSTANT(100),
+    G_GUINT64_CONSTANT(1000),
+    G_GUINT64_CONSTANT(10000),
+    G_GUINT64_CONSTANT(100000),
+    G_GUINT64_CONSTANT(1000000),
+    G_GUINT64_CONSTANT(10000000),
+    G_GUINT64_CONSTANT(100000000),
+    G_GUINT64_CONSTANT(1000000000),
+    G_GUINT64_CONSTANT(10000000000),
+    G_GUINT64_CONSTANT(100000000000),
+    G_GUINT64_CONSTANT(1000000000000),
+    G_GUINT64_CONSTANT(10000000000000),
+    G_GUINT64_CONSTANT(100000000000000),
+    G_GUINT64_CONSTANT(1000000000000000),
+    G_GUINT64_CONSTANT(10000000000000000),
+    G_GUINT64_CONSTANT(100000000000000000),
+    G_GUINT64_CONSTANT(1000000000000000000),
+    G_GUINT64_CONSTANT(10000000000000000000),
+};
+
+
+static gboolean
+parse_number(const gchar **p, gint *number, gint max)
+{
+    gint result = 0;
+
+    while (g_ascii_isdigit(**p)) {
+        result = result * 10 + (**p - '0');
+        if (result > max) {
+            return FALSE;
+        }
+        ++*p;
+    }
+
+    *number = result;
+    return TRUE;
+}
+
+/* Parses the conversion starting after the '%' */
+static gboolean
+parse_conversion(AgwNumericFormat *format, const gchar **text)
+{
+    const gchar *p = *text;
+    GString *spec;
+
+    for (;; ++p) {
+        if (*p == '-') {
+            format->left = TRUE;
+        } else if (*p == '+') {
+            format->sign = '+';
+        } else if (*p == ' ') {
+            if (format->sign == 0) {
+                format->sign = ' ';
+            }
+        } else if (*p == '#') {
+            format->alternate = TRUE;
+        } else if (*p == '0') {
+            format->zero = TRUE;
+        } else if (*p == '\'') {
+            format->grouping = TRUE;
+        } else {
+            break;
+        }
+    }
+
+    /* `*` would read a missing argument */
+    if (!parse_number(&p, &format->width, MAX_WIDTH)) {
+        return FALSE;
+    }
+    if (*p == '.') {
+        ++p;
+        if (!parse_number(&p, &format->precision, MAX_PRECISION)) {
+            return FALSE;
+        }
+    }
+
+    /* `l` is allowed but meaningless, `L` would read a long double */
+    if (*p == 'l') {
+        ++p;
+    }
+    if (*p == '\0' || strchr("fFeEgGaA", *p) == NULL) {
+        return FALSE;
+    }
+    format->conversion = *p;
+    *text = p + 1;
+
+    /* The same conversion, rebuilt from the parsed fields */
+    spec = g_string_new("%");
+    if (format->left) {
+        g_string_append_c(spec, '-');
+    }
+    if (format->sign != 0) {
+        g_string_append_c(spec, format->sign);
+    }
+    if (format->alternate) {
+        g_string_append_c(spec, '#');
+    }
+    if (format->zero) {
+        g_string_append_c(spec, '0');
+    }
+    if (format->grouping) {
+        g_string_append_c(spec, '\'');
+    }
+    if (format->width > 0) {
+        g_string_append_printf(spec, "%d", format->width);
+    }
+    if (format->precision >= 0) {
+        g_string_append_printf(spec, ".%d", format->precision);
+    }
+    g_string_append_c(spec, format->conversion);
+    g_strlcpy(format->spec, spec->str, sizeof(format->spec));
+    g_string_free(spec, TRUE);
+
+    return TRUE;
+}
+
+/* Rounds `scaled` (non-negative, below MAX_FAST_SCALED) to an integer.
+ * Returns FALSE if it is too close to a tie: printf() rounds the exact
+ * binary value, so the result would depend on digits lost here. */
+static gboolean
+round_scaled(gdouble scaled, guint64 *number)
+{
+    gdouble whole, fraction;
+
+    whole = floor(scaled);
+    fraction = scaled - whole;
+    if (fabs(fraction - 0.5) < TIE_WINDOW) {
+        return FALSE;
+    }
+
+    *number = (guint64) whole + (fraction > 0.5 ? 1 : 0);
+    return TRUE;
+}
+
+/* Writes `integer`, the decimal point, the last `precision` digits of
+ * `decimals` and `exponent`, with the sign and the padding required by
+ * `format`. Returns 0 if `buffer` is too small. */
+static gsize
+print_digits(const AgwNumericFormat *format, gboolean negative,
+             guint64 integer, guint64 decimals, gint precision,
+             const gchar *exponent, gchar *buffer, gsize size)
+{
+    gchar digits[24];
+    const gchar *point;
+    gchar sign, *p;
+    gint n_digits, n;
+    gsize point_len, exponent_len, len, pad;
+
+    /* Integer digits, in reverse order */
+    n_digits = 0;
+    do {
+        digits[n_digits++] = '0' + integer % 10;
+        integer /= 10;
+    } while (integer > 0);
+
+    sign = negative ? '-' : format->sign;
+    point = localeconv()->decimal_point;
+    point_len = precision > 0 || format->alternate ? strlen(point) : 0;
+    exponent_len = strlen(exponent);
+
+    len = (sign != 0 ? 1 : 0) + n_digits + point_len + precision + exponent_len;
+    pad = (gsize) format->width > len ? format->width - len : 0;
+    if (len + pad >= size) {
+        return 0;
+    }
+
+    p = buffer;
+    if (!format->left && !format->zero) {
+        memset(p, ' ', pad);
+        p += pad;
+    }
+    if (sign != 0) {
+        *p++ = sign;
+    }
+    if (!format->left && format->zero) {
+        memset(p, '0', pad);
+        p += pad;
+    }
+    while (n_digits > 0) {
+        *p++ = digits[--n_digits];
+    }
+    memcpy(p, point, point_len);
+    p += point_len;
+    for (n = precision - 1; n >= 0; --n) {
+        p[n] = '0' + decimals % 10;
+        decimals /= 10;
+    }
+    p += precision;
+    memcpy(p, exponent, exponent_len);
+    p += exponent_len;
+    if (format->left) {
+        memset(p, ' ', pad);
+        p += pad;
+    }
+    *p = '\0';
+
+    return p - buffer;
+}
+
+/* Formats the `%f` conversion without printf(). Returns 0 when the
+ * value cannot be handled, leaving the job to the slow path. */
+static gsize
+print_fixed(const AgwNumericFormat *format, gdouble value, gchar *buffer, gsize size)
+{
+    gint precision;
+    gdouble scaled;
+    guint64 number;
+
+    precision = format->precision >= 0 ? format->precision : 6;
+    if (precision > MAX_FAST_DIGITS || !isfinite(value)) {
+        return 0;
+    }
+
+    scaled = fabs(value) * pow10[precision];
+    if (scaled >= MAX_FAST_SCALED || !round_scaled(scaled, &number)) {
+        return 0;
+    }
+
+    /* As printf(), negative values rounded to 0 keep their sign */
+    return print_digits(format, signbit(value),
+                        number / pow10[precision], number % pow10[precision],
+                        precision, "", buffer, size);
+}
+
+/* Multiplies `value` by 10^`exponent`: the power is exact, so this adds
+ * a single rounding error */
+static gdouble
+scale(gdouble value, gint exponent)
+{
+    return exponent >= 0 ?
+        value * (gdouble) pow10[exponent] :
+        value / (gdouble) pow10[-exponent];
+}
+
+/* Formats the `%g` conversion without printf(). Returns 0 when the
+ * value cannot be handled, leaving the job to the slow path. */
+static gsize
+print_general(const AgwNumericFormat *format, gdouble value, gchar *buffer, gsize size)
+{
+    gchar exponent[8];
+    gint precision, decimals, x;
+    gdouble magnitude, scaled;
+    guint64 number, divisor;
+
+    precision = format->precision >= 0 ? format->precision : 6;
+    if (precision == 0) {
+        precision = 1;
+    }
+    if (precision > MAX_FAST_DIGITS || !isfinite(value)) {
+        return 0;
+    }
+
+    /* Round to `precision` significant digits: `number` is then in
+     * [10^(precision-1), 10^precision) and `x` is the exponent %e would
+     * print. log10() can be off by one, hence the adjustments. */
+    magnitude = fabs(value);
+    if (magnitude == 0) {
+        x = 0;
+        number = 0;
+    } else {
+        x = (gint) floor(log10(magnitude));
+        if (ABS(precision - 1 - x) > MAX_POW10) {
+            return 0;
+        }
+        scaled = scale(magnitude, precision - 1 - x);
+        if (scaled >= pow10[precision]) {
+            ++x;
+        } else if (scaled < pow10[precision - 1]) {
+            --x;
+        }
+        if (ABS(precision - 1 - x) > MAX_POW10) {
+            return 0;
+        }
+        scaled = scale(magnitude, precision - 1 - x);
+        if (scaled < pow10[precision - 1] || scaled >= pow10[precision] ||
+            !round_scaled(scaled, &number)) {
+            return 0;
+        }
+        if (number == pow10[precision]) {
+            /* Rounded up to the next power of 10: with `#` glibc drops
+             * a trailing zero here, so leave it to printf() */
+            if (format->alternate) {
+                return 0;
+            }
+            number /= 10;
+            ++x;
+        }
+    }
+
+    if (x < -4 || x >= precision) {
+        /* Exponential style: d.ddde+XX */
+        divisor = pow10[precision - 1];
+        decimals = precision - 1;
+        /* |x| is at most MAX_POW10 + MAX_FAST_DIGITS, so two digits */
+        exponent[0] = format->conversion == 'G' ? 'E' : 'e';
+        exponent[1] = x < 0 ? '-' : '+';
+        exponent[2] = '0' + ABS(x) / 10;
+        exponent[3] = '0' + ABS(x) % 10;
+        exponent[4] = '\0';
+    } else {
+        /* Fixed style, with precision - 1 - x decimals */
+        decimals = precision - 1 - x;
+        divisor = pow10[decimals];
+        exponent[0] = '\0';
+    }
+
+    /* Trailing zeros are dropped, unless the `#` flag is set */
+    if (!format->alternate) {
+        while (decimals > 0 && number % 10 == 0) {
+            number /= 10;
+            divisor /= 10;
+            --decimals;
+        }
+    }
+
+    return print_digits(format, signbit(value),
+                        number / divisor, number % divisor,
+                        decimals, exponent, buffer, size);
+}
+
+
+/*
+ * agw_numeric_format_new:
+ * @format: a printf-style format
+ *
+ * Parses @format, accepting literal text, `%%` and at most one
+ * `f`, `F`, `e`, `E`, `g`, `G`, `a` or `A` conversion, with optional
+ * flags, width and precision. `*` and any other conversion, that would
+ * read non existing arguments, are rejected.
+ *
+ * Returns: the parsed format, to be freed with agw_numeric_format_free(),
+ *          or %NULL if @format is not valid
+ */
+AgwNumericFormat *
+agw_numeric_format_new(const gchar *format)
+{
+    AgwNumericFormat *result;
+    GString *text;
+    const gchar *p;
+
+    g_return_val_if_fail(format != NULL, NULL);
+
+    result = g_new0(AgwNumericFormat, 1);
+    result->precision = -1;
+    text = g_string_new(NULL);
+
+    for (p = format; *p != '\0'; ++p) {
+        if (*p != '%') {
+            g_string_append_c(text, *p);
+        } else if (p[1] == '%') {
+            g_string_append_c(text, '%');
+            ++p;
+        } else if (result->conversion != 0) {
+            /* Only one value can be formatted */
+            goto invalid;
+        } else {
+            ++p;
+            if (!parse_conversion(result, &p)) {
+                goto invalid;
+            }
+            result->prefix = g_string_free(text, FALSE);
+            result->prefix_len = strlen(result->prefix);
+            text = g_string_new(NULL);
+            --p;
+        }
+    }
+
+    if (result->conversion == 0) {
+        result->prefix = g_string_free(text, FALSE);
+        result->prefix_len = strlen(result->prefix);
+        result->suffix = g_strdup("");
+    } else {
+        result->suffix = g_string_free(text, FALSE);
+        result->suffix_len = strlen(result->suffix);
+    }
+
+    return result;
+
+invalid:
+    g_string_free(text, TRUE);
+    agw_numeric_format_free(result);
+    return NULL;
+}
+
+void
+agw_numeric_format_free(AgwNumericFormat *format)
+{
+    if (format != NULL) {
+        g_free(format->prefix);
+        g_free(format->suffix);
+        g_free(format);
+    }
+}
+
+/*
+ * agw_numeric_format_print:
+ * @format: an #AgwNumericFormat
+ * @value: the value to format
+ * @buffer: where to store the NUL terminated text
+ * @size: size of @buffer
+ *
+ * Formats @value, with no heap allocations in the common cases.
+ *
+ * Returns: the length of the text (without the trailing NUL) or, if
+ *          it does not fit in @buffer, the size needed to store it
+ *          minus one, as snprintf(); @buffer is not modified then
+ */
+gsize
+agw_numeric_format_print(const AgwNumericFormat *format, gdouble value,
+                         gchar *buffer, gsize size)
+{
+    gchar number[AGW_NUMERIC_FORMAT_BUFFER];
+    gchar *heap;
+    const gchar *digits;
+    gsize len, total;
+
+    heap = NULL;
+    digits = number;
+    if (format->conversion == 0) {
+        len = 0;
+    } else {
+        len = 0;
+        if (format->grouping) {
+            /* Left to printf() */
+        } else if (format->conversion == 'f' || format->conversion == 'F') {
+            len = print_fixed(format, value, number, sizeof(number));
+        } else if (format->conversion == 'g' || format->conversion == 'G') {
+            len = print_general(format, value, number, sizeof(number));
+        }
+        if (len == 0) {
+            len = g_snprintf(number, sizeof(number), format->spec, value);
+            if (len >= sizeof(number)) {
+                /* Huge %f or precision values */
+                heap = g_strdup_printf(format->spec, value);
+                digits = heap;
+            }
+        }
+    }
+
+    total = format->prefix_len + len + format->suffix_len;
+    if (total < size) {
+        memcpy(buffer, format->prefix, format->prefix_len);
+        memcpy(buffer + format->prefix_len, digits, len);
+        memcpy(buffer + format->prefix_len + len, format->suffix, format->suffix_len);
+        buffer[total] = '\0';
+    }
+
+    g_free(heap);
+    return total;
+}
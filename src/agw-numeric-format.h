@@ -0,0 +1,66 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Private header: not installed and not part of the public API */
+
+#ifndef __AGW_NUMERIC_FORMAT_H__
+#define __AGW_NUMERIC_FORMAT_H__
+
+#include <glib.h>
+
+
+G_BEGIN_DECLS
+
+/* Enough for any number formatted with the fast path */
+#define AGW_NUMERIC_FORMAT_BUFFER   128
+
+typedef struct _AgwNumericFormat AgwNumericFormat;
+
+/* A printf-style format with at most one floating point conversion,
+ * parsed once and then used to format many values */
+struct _AgwNumericFormat {
+    gchar *     prefix;
+    gsize       prefix_len;
+    gchar *     suffix;
+    gsize       suffix_len;
+    /* One of "fFeEgGaA", or 0 if there is no conversion at all */
+    gchar       conversion;
+    gint        width;
+    /* -1 if not specified */
+    gint        precision;
+    gboolean    left;
+    gboolean    zero;
+    gboolean    alternate;
+    gboolean    grouping;
+    /* '+', ' ' or 0 */
+    gchar       sign;
+    /* The conversion alone, e.g. "%+08.3f", for the slow path */
+    gchar       spec[16];
+};
+
+AgwNumericFormat *  agw_numeric_format_new      (const gchar *          format);
+void                agw_numeric_format_free     (AgwNumericFormat *     format);
+gsize               agw_numeric_format_print    (const AgwNumericFormat *format,
+                                                 gdouble                value,
+                                                 gchar *                buffer,
+                                                 gsize                  size);
+
+G_END_DECLS
+
+
+#endif /* __AGW_NUMERIC_FORMAT_H__ */
@@ -24,9 +24,32 @@
  * property is also useful to bind it to a numerical GSettings key.
  *
  * You can customize the way the value is formatted by using
- * agw_numeric_label_set_format(): that string will be passed directly
- * to sprintf(), so be sure to include one (and only one)
- * `%f`-compatible argument. By default the format is set to `"%g"`.
+ * agw_numeric_label_set_format(): a printf-style string with at most
+ * one floating point conversion. By default the format is set to
+ * `"%g"`.
+ *
+ * When the value changes faster than anybody can read, set
+ * #AgwNumericLabel:max-update-rate: the `value` property keeps tracking
+ * every change but the text is refreshed at most that many times per
+ * second, in sync with the frame clock, always showing the latest
+ * value.
+ *
+ * Every text change of a plain `GtkLabel` queues a resize, that in turn
+ * reallocates all the containers up to the toplevel. To avoid that on
+ * panels full of live values, enable #AgwNumericLabel:stable: the label
+ * then reserves the width of the widest text, computed from the format
+ * and the range declared by agw_numeric_label_set_range() or, if there
+ * is none, the widest text shown so far, and uses tabular digits. The
+ * value changes just queue a redraw, unless the text gets wider than
+ * the reserved width. In this mode the `GtkLabel` text holds the
+ * reserving text, so use agw_numeric_label_get_value() to know what is
+ * actually shown.
+ *
+ * In stable mode, enabling #AgwNumericLabel:glyph-cache skips Pango
+ * altogether on value changes: the glyphs of the characters used by
+ * numbers (and of the literal text of the format) are shaped once per
+ * font and every new text is drawn straight from them. Texts with
+ * other characters fall back to the usual Pango rendering.
  **/
 
 /**
@@ -37,11 +60,41 @@
  **/
 
 #include "agw-numeric-label.h"
+#include "agw-numeric-format.h"
+#include "agw-glyph-cache.h"
+#include "agw-perf.h"
+#include <locale.h>
+#include <math.h>
+#include <string.h>
 
 
 typedef struct {
-    gchar * format;
-    gdouble value;
+    gchar *     format;
+    AgwNumericFormat *compiled;
+    gdouble     value;
+    gdouble     max_update_rate;
+    /* Frame time of the last text update, for rate limiting */
+    gint64      updated;
+    guint       tick_id;
+    guint       timeout_id;
+    gboolean    stable;
+    gdouble     lower;
+    gdouble     upper;
+    /* Stable mode: the text is drawn from this layout, while the
+     * GtkLabel one holds the widest text to reserve its width */
+    PangoLayout *layout;
+    gint        reserved;
+    PangoAttrList *attrs;
+    PangoAttrList *user_attrs;
+    /* Glyph cache path: when n_run >= 0, the text in shown is drawn
+     * from run instead of layout */
+    gboolean    glyph_cache;
+    AgwGlyphCache *glyphs;
+    gboolean    glyphs_failed;
+    cairo_glyph_t run[AGW_NUMERIC_FORMAT_BUFFER];
+    gint        n_run;
+    gdouble     run_width;
+    gchar       shown[AGW_NUMERIC_FORMAT_BUFFER];
 } AgwNumericLabelPrivate;
 
 struct _AgwNumericLabel {
@@ -54,21 +107,381 @@ enum {
     PROP_0,
     PROP_FORMAT,
     PROP_VALUE,
+    PROP_MAX_UPDATE_RATE,
+    PROP_STABLE,
+    PROP_LOWER,
+    PROP_UPPER,
+    PROP_GLYPH_CACHE,
     NUM_PROPERTIES,
 };
 
 static GParamSpec *props[NUM_PROPERTIES] = { 0 };
 
 
+/* Formats @value into @buffer, of AGW_NUMERIC_FORMAT_BUFFER bytes.
+ * Returns: @buffer or, if the text does not fit, a newly allocated
+ *          string to be freed with g_free() */
+static gchar *
+format_value(AgwNumericLabel *label, gdouble value, gchar *buffer)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    gchar *text;
+    gsize len;
+
+    len = agw_numeric_format_print(priv->compiled, value, buffer, AGW_NUMERIC_FORMAT_BUFFER);
+    if (len < AGW_NUMERIC_FORMAT_BUFFER) {
+        return buffer;
+    }
+
+    text = g_malloc(len + 1);
+    agw_numeric_format_print(priv->compiled, value, text, len + 1);
+    return text;
+}
+
+static PangoLayout *
+create_layout(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    PangoLayout *layout = gtk_widget_create_pango_layout(GTK_WIDGET(label), NULL);
+
+    pango_layout_set_attributes(layout, priv->attrs);
+    return layout;
+}
+
+static gint
+text_width(PangoLayout *layout, const gchar *text)
+{
+    gint width;
+
+    pango_layout_set_text(layout, text, -1);
+    pango_layout_get_pixel_size(layout, &width, NULL);
+    return width;
+}
+
+/* Drops whatever is used to draw the value in stable mode */
+static void
+drop_rendering(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    g_clear_object(&priv->layout);
+    agw_glyph_cache_free(priv->glyphs);
+    priv->glyphs = NULL;
+    priv->glyphs_failed = FALSE;
+    priv->n_run = -1;
+}
+
+static AgwGlyphCache *
+create_glyphs(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    AgwGlyphCache *glyphs;
+    PangoLayout *layout;
+    gchar *charset;
+
+    /* Whatever printf() can emit for a double, plus the format text */
+    charset = g_strconcat("0123456789+-.,eE infaINFAxXpPbcdBCD",
+                          localeconv()->decimal_point,
+                          priv->compiled->prefix,
+                          priv->compiled->suffix,
+                          NULL);
+    layout = create_layout(label);
+    glyphs = agw_glyph_cache_new(layout, charset);
+    g_object_unref(layout);
+    g_free(charset);
+
+    return glyphs;
+}
+
+/* Tries to convert @text with the glyph cache. On success the text is
+ * ready to be drawn with cairo_show_glyphs(). */
+static gboolean
+map_glyphs(AgwNumericLabel *label, const gchar *text)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    if (!priv->glyph_cache || priv->glyphs_failed) {
+        return FALSE;
+    }
+
+    if (priv->glyphs == NULL) {
+        priv->glyphs = create_glyphs(label);
+        if (priv->glyphs == NULL) {
+            /* Do not try again until the font changes */
+            priv->glyphs_failed = TRUE;
+            return FALSE;
+        }
+    }
+
+    if (strlen(text) >= sizeof(priv->shown) ||
+        !agw_glyph_cache_map(priv->glyphs, text, priv->run, G_N_ELEMENTS(priv->run),
+                             &priv->n_run, &priv->run_width)) {
+        priv->n_run = -1;
+        return FALSE;
+    }
+
+    strcpy(priv->shown, text);
+    return TRUE;
+}
+
+/* Sets the GtkLabel text to the widest text expected, so its size
+ * request covers any value. The value layout is dropped, to be
+ * recreated by the next agw_numeric_label_update_text() call. */
+static void
+reserve_width(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    gchar buffer[AGW_NUMERIC_FORMAT_BUFFER], other_buffer[AGW_NUMERIC_FORMAT_BUFFER];
+    gchar *text, *other;
+    PangoLayout *layout;
+    gint width, other_width;
+
+    drop_rendering(label);
+    layout = create_layout(label);
+
+    if (priv->lower < priv->upper) {
+        /* With tabular digits one of the extremes is the widest */
+        text = format_value(label, priv->lower, buffer);
+        other = format_value(label, priv->upper, other_buffer);
+        width = text_width(layout, text);
+        other_width = text_width(layout, other);
+        if (other_width > width) {
+            width = other_width;
+            if (text != buffer) {
+                g_free(text);
+            }
+            text = other;
+        } else if (other != other_buffer) {
+            g_free(other);
+        }
+    } else {
+        /* No range: start over from the current text */
+        text = format_value(label, priv->value, buffer);
+        width = text_width(layout, text);
+    }
+
+    priv->reserved = width;
+    gtk_label_set_label(GTK_LABEL(label), text);
+
+    if (text != buffer && text != other_buffer) {
+        g_free(text);
+    }
+    g_object_unref(layout);
+}
+
+static void
+set_text(AgwNumericLabel *label, const gchar *text)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    gint width;
+
+    if (!priv->stable) {
+        if (g_strcmp0(text, gtk_label_get_label(GTK_LABEL(label))) != 0) {
+            gtk_label_set_label(GTK_LABEL(label), text);
+        }
+        return;
+    }
+
+    /* Nothing to do if the text did not change */
+    if (priv->n_run >= 0) {
+        if (strcmp(text, priv->shown) == 0) {
+            return;
+        }
+    } else if (priv->layout != NULL &&
+               g_strcmp0(text, pango_layout_get_text(priv->layout)) == 0) {
+        return;
+    }
+
+    if (map_glyphs(label, text)) {
+        width = ceil(priv->run_width);
+    } else {
+        if (priv->layout == NULL) {
+            priv->layout = create_layout(label);
+        }
+        width = text_width(priv->layout, text);
+    }
+
+    if (width > priv->reserved) {
+        /* Wider than ever (or out of range): this is the new reference */
+        priv->reserved = width;
+        gtk_label_set_label(GTK_LABEL(label), text);
+    } else {
+        gtk_widget_queue_draw(GTK_WIDGET(label));
+    }
+}
+
+static void
+cancel_update(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    if (priv->tick_id != 0) {
+        gtk_widget_remove_tick_callback(GTK_WIDGET(label), priv->tick_id);
+        priv->tick_id = 0;
+    }
+    if (priv->timeout_id != 0) {
+        g_source_remove(priv->timeout_id);
+        priv->timeout_id = 0;
+    }
+}
+
+static gboolean
+update_tick(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+    AgwNumericLabel *label = AGW_NUMERIC_LABEL(widget);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    /* agw_numeric_label_update_text() would remove the callback */
+    priv->tick_id = 0;
+    agw_numeric_label_update_text(label);
+    priv->updated = gdk_frame_clock_get_frame_time(frame_clock);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+update_timeout(gpointer user_data)
+{
+    AgwNumericLabel *label = AGW_NUMERIC_LABEL(user_data);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    /* The interval is over: update the text on the next frame */
+    priv->timeout_id = 0;
+    priv->tick_id = gtk_widget_add_tick_callback(GTK_WIDGET(label), update_tick, NULL, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_update(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    GtkWidget *widget = GTK_WIDGET(label);
+    gint64 now, next;
+
+    /* Nothing to coalesce when not limited or not on screen */
+    if (priv->max_update_rate <= 0 || !gtk_widget_get_mapped(widget)) {
+        agw_numeric_label_update_text(label);
+        return;
+    }
+
+    /* Already scheduled: the latest value will be used */
+    if (priv->tick_id != 0 || priv->timeout_id != 0) {
+        return;
+    }
+
+    /* Sleep, instead of ticking every frame, until the interval is over */
+    now = gdk_frame_clock_get_frame_time(gtk_widget_get_frame_clock(widget));
+    next = priv->updated + G_USEC_PER_SEC / priv->max_update_rate;
+    if (next > now) {
+        priv->timeout_id = g_timeout_add((next - now + 999) / 1000, update_timeout, label);
+    } else {
+        priv->tick_id = gtk_widget_add_tick_callback(widget, update_tick, NULL, NULL);
+    }
+}
+
+static void
+unmap(GtkWidget *widget)
+{
+    AgwNumericLabel *label = AGW_NUMERIC_LABEL(widget);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    /* Apply any pending value, so the text is right when shown again */
+    if (priv->tick_id != 0 || priv->timeout_id != 0) {
+        agw_numeric_label_update_text(label);
+    }
+    GTK_WIDGET_CLASS(agw_numeric_label_parent_class)->unmap(widget);
+}
+
+static void
+style_updated(GtkWidget *widget)
+{
+    AgwNumericLabel *label = AGW_NUMERIC_LABEL(widget);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    GTK_WIDGET_CLASS(agw_numeric_label_parent_class)->style_updated(widget);
+
+    /* The font could have changed: measure everything again */
+    if (priv->stable) {
+        reserve_width(label);
+        agw_numeric_label_update_text(label);
+    }
+}
+
+static gboolean
+draw(GtkWidget *widget, cairo_t *cr)
+{
+    AgwNumericLabel *label = AGW_NUMERIC_LABEL(widget);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+    GtkStyleContext *context;
+    GtkAllocation allocation;
+    GdkRGBA color;
+    gint x, y, used;
+    gfloat xalign;
+
+    if (!priv->stable || (priv->n_run < 0 && priv->layout == NULL)) {
+        return GTK_WIDGET_CLASS(agw_numeric_label_parent_class)->draw(widget, cr);
+    }
+
+    context = gtk_widget_get_style_context(widget);
+    gtk_widget_get_allocation(widget, &allocation);
+    gtk_render_background(context, cr, 0, 0, allocation.width, allocation.height);
+    gtk_render_frame(context, cr, 0, 0, allocation.width, allocation.height);
+
+    /* Draw the value where GtkLabel would draw the reserving text,
+     * aligned inside it as the label is aligned in its allocation */
+    gtk_label_get_layout_offsets(GTK_LABEL(label), &x, &y);
+    if (priv->n_run >= 0) {
+        used = ceil(priv->run_width);
+    } else {
+        pango_layout_get_pixel_size(priv->layout, &used, NULL);
+    }
+    xalign = gtk_label_get_xalign(GTK_LABEL(label));
+    if (gtk_widget_get_direction(widget) == GTK_TEXT_DIR_RTL) {
+        xalign = 1 - xalign;
+    }
+    x += (priv->reserved - used) * xalign - allocation.x;
+    y -= allocation.y;
+
+    if (priv->n_run < 0) {
+        gtk_render_layout(context, cr, x, y, priv->layout);
+        return FALSE;
+    }
+
+    gtk_style_context_get_color(context, gtk_style_context_get_state(context), &color);
+    cairo_save(cr);
+    gdk_cairo_set_source_rgba(cr, &color);
+    cairo_set_scaled_font(cr, priv->glyphs->scaled_font);
+    cairo_translate(cr, x, y + priv->glyphs->baseline);
+    cairo_show_glyphs(cr, priv->run, priv->n_run);
+    cairo_restore(cr);
+
+    return FALSE;
+}
+
+static void
+dispose(GObject *object)
+{
+    AgwNumericLabel *label = AGW_NUMERIC_LABEL(object);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
+
+    cancel_update(label);
+    drop_rendering(label);
+    g_clear_pointer(&priv->attrs, pango_attr_list_unref);
+    g_clear_pointer(&priv->user_attrs, pango_attr_list_unref);
+    G_OBJECT_CLASS(agw_numeric_label_parent_class)->dispose(object);
+}
+
 static void
 finalize(GObject *object)
 {
     AgwNumericLabel *label = AGW_NUMERIC_LABEL(object);
     AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
-    if (priv->format != NULL) {
-        g_free(priv->format);
-        priv->format = NULL;
-    }
+
+    g_free(priv->format);
+    priv->format = NULL;
+    agw_numeric_format_free(priv->compiled);
+    priv->compiled = NULL;
+
+    G_OBJECT_CLASS(agw_numeric_label_parent_class)->finalize(object);
 }
 
 static void
@@ -85,6 +498,21 @@ get_property(GObject *object, guint prop_id,
     case PROP_VALUE:
         g_value_set_double(value, priv->value);
         break;
+    case PROP_MAX_UPDATE_RATE:
+        g_value_set_double(value, priv->max_update_rate);
+        break;
+    case PROP_STABLE:
+        g_value_set_boolean(value, priv->stable);
+        break;
+    case PROP_LOWER:
+        g_value_set_double(value, priv->lower);
+        break;
+    case PROP_UPPER:
+        g_value_set_double(value, priv->upper);
+        break;
+    case PROP_GLYPH_CACHE:
+        g_value_set_boolean(value, priv->glyph_cache);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
         break;
@@ -96,6 +524,7 @@ set_property(GObject *object, guint prop_id,
              const GValue *value, GParamSpec *pspec)
 {
     AgwNumericLabel *label = AGW_NUMERIC_LABEL(object);
+    AgwNumericLabelPrivate *priv = agw_numeric_label_get_instance_private(label);
 
     switch (prop_id) {
     case PROP_FORMAT:
@@ -104,6 +533,21 @@ set_property(GObject *object, guint prop_id,
     case PROP_VALUE:
         agw_numeric_label_set_value(label, g_value_get_double(value));
         break;
+    case PROP_MAX_UPDATE_RATE:
+        agw_numeric_label_set_max_update_rate(label, g_value_get_double(value));
+        break;
+    case PROP_STABLE:
+        agw_numeric_label_set_stable(label, g_value_get_boolean(value));
+        break;
+    case PROP_LOWER:
+        agw_numeric_label_set_range(label, g_value_get_double(value), priv->upper);
+        break;
+    case PROP_UPPER:
+        agw_numeric_label_set_range(label, priv->lower, g_value_get_double(value));
+        break;
+    case PROP_GLYPH_CACHE:
+        agw_numeric_label_set_glyph_cache(label, g_value_get_boolean(value));
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
         break;
@@ -115,8 +559,10 @@ static void
 agw_numeric_label_class_init(AgwNumericLabelClass *class)
 {
     GObjectClass *gobject_class;
+    GtkWidgetClass *widget_class;
 
     gobject_class = G_OBJECT_CLASS(class);
+    gobject_class->dispose = dispose;
     gobject_class->finalize = finalize;
     gobject_class->get_property = get_property;
     gobject_class->set_property = set_property;
@@ -131,8 +577,38 @@ agw_numeric_label_class_init(AgwNumericLabelClass *class)
                                             "Value to display",
                                             -G_MAXDOUBLE, G_MAXDOUBLE, 0,
                                             G_PARAM_READWRITE);
+    props[PROP_MAX_UPDATE_RATE] = g_param_spec_double("max-update-rate",
+                                                      "Maximum Update Rate",
+                                                      "Maximum number of text updates per second, 0 for no limit",
+                                                      0, G_MAXDOUBLE, 0,
+                                                      G_PARAM_READWRITE);
+    props[PROP_STABLE] = g_param_spec_boolean("stable",
+                                              "Stable Layout",
+                                              "Whether to reserve the width of the widest text, so value changes do not resize the label",
+                                              FALSE,
+                                              G_PARAM_READWRITE);
+    props[PROP_LOWER] = g_param_spec_double("lower",
+                                            "Lower Value",
+                                            "Lowest expected value, used to reserve the width in stable mode",
+                                            -G_MAXDOUBLE, G_MAXDOUBLE, 0,
+                                            G_PARAM_READWRITE);
+    props[PROP_UPPER] = g_param_spec_double("upper",
+                                            "Upper Value",
+                                            "Highest expected value, used to reserve the width in stable mode",
+                                            -G_MAXDOUBLE, G_MAXDOUBLE, 0,
+                                            G_PARAM_READWRITE);
+    props[PROP_GLYPH_CACHE] = g_param_spec_boolean("glyph-cache",
+                                                   "Glyph Cache",
+                                                   "Whether to draw the text from glyphs shaped once, in stable mode",
+                                                   FALSE,
+                                                   G_PARAM_READWRITE);
 
     g_object_class_install_properties(gobject_class, NUM_PROPERTIES, props);
+
+    widget_class = GTK_WIDGET_CLASS(class);
+    widget_class->unmap = unmap;
+    widget_class->style_updated = style_updated;
+    widget_class->draw = draw;
 }
 
 static void
@@ -144,7 +620,9 @@ agw_numeric_label_init(AgwNumericLabel *label)
     gtk_label_set_use_underline(GTK_LABEL(label), FALSE);
 
     priv->format = g_strdup("%g");
+    priv->compiled = agw_numeric_format_new(priv->format);
     priv->value = 0;
+    priv->n_run = -1;
 
     /* Ensure the text is updated at least once */
     agw_numeric_label_update_text(label);
@@ -168,11 +646,14 @@ agw_numeric_label_new(void)
 /**
  * agw_numeric_label_set_format:
  * @label: an #AgwNumericLabel
- * @format: the new format to adopt
+ * @format: (allow-none): the new format to adopt
  *
- * Sets a new format string to use for @label. This string is passed
- * directly to sprintf(), so be sure to include one (and only one)
- * `%f`-compatible argument. By default the format is set to `"%g"`.
+ * Sets a new format string to use for @label. This is a printf-style
+ * string with at most one `f`, `F`, `e`, `E`, `g`, `G`, `a` or `A`
+ * conversion, optionally with flags, width and precision. Use `%%` for
+ * a literal percent sign. Formats that do not follow these rules (e.g.
+ * containing `%s`, `%d` or `*`) are rejected with a warning and the
+ * old format is kept. Use %NULL to restore the default `"%g"` format.
  *
  * Changing the format triggers the update of the text with an
  * agw_numeric_label_update_text() call.
@@ -181,17 +662,35 @@ void
 agw_numeric_label_set_format(AgwNumericLabel *label, const gchar *format)
 {
     AgwNumericLabelPrivate *priv;
+    AgwNumericFormat *compiled;
 
     g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
 
-    /* g_strcmp0 and g_strdup already handle NULL gracefully */
+    if (format == NULL) {
+        format = "%g";
+    }
+
     priv = agw_numeric_label_get_instance_private(label);
-    if (g_strcmp0(format, priv->format) != 0) {
-        g_free(priv->format);
-        priv->format = g_strdup(format);
-        g_object_notify_by_pspec(G_OBJECT(label), props[PROP_FORMAT]);
-        agw_numeric_label_update_text(label);
+    if (g_strcmp0(format, priv->format) == 0) {
+        return;
+    }
+
+    /* Parse the format here, once for all */
+    compiled = agw_numeric_format_new(format);
+    if (compiled == NULL) {
+        g_warning("Invalid AgwNumericLabel format \"%s\"", format);
+        return;
+    }
+
+    g_free(priv->format);
+    priv->format = g_strdup(format);
+    agw_numeric_format_free(priv->compiled);
+    priv->compiled = compiled;
+    g_object_notify_by_pspec(G_OBJECT(label), props[PROP_FORMAT]);
+    if (priv->stable) {
+        reserve_width(label);
     }
+    agw_numeric_label_update_text(label);
 }
 
 /**
@@ -219,7 +718,8 @@ agw_numeric_label_get_format(AgwNumericLabel *label)
  * @value: new value
  *
  * Sets a new value for the label. This in turn triggers the update of
- * the text with an agw_numeric_label_update_text() call.
+ * the text with an agw_numeric_label_update_text() call, possibly
+ * delayed according to #AgwNumericLabel:max-update-rate.
  **/
 void
 agw_numeric_label_set_value(AgwNumericLabel *label, gdouble value)
@@ -232,7 +732,7 @@ agw_numeric_label_set_value(AgwNumericLabel *label, gdouble value)
     if (value != priv->value) {
         priv->value = value;
         g_object_notify_by_pspec(G_OBJECT(label), props[PROP_VALUE]);
-        agw_numeric_label_update_text(label);
+        schedule_update(label);
     }
 }
 
@@ -255,24 +755,279 @@ agw_numeric_label_get_value(AgwNumericLabel *label)
     return priv->value;
 }
 
+/**
+ * agw_numeric_label_set_max_update_rate:
+ * @label: an #AgwNumericLabel
+ * @rate: maximum number of text updates per second, or 0
+ *
+ * Limits how often the text is updated when the value changes. The
+ * value changes in between are coalesced: the #AgwNumericLabel:value
+ * property and its notifications stay accurate, but the text shows
+ * the latest value only when the interval is over, on the next frame.
+ * Set it to 0 (the default) to update the text on every change.
+ *
+ * A @rate higher than the refresh rate of the display means at most
+ * one update per frame.
+ **/
+void
+agw_numeric_label_set_max_update_rate(AgwNumericLabel *label, gdouble rate)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
+    g_return_if_fail(rate >= 0);
+
+    priv = agw_numeric_label_get_instance_private(label);
+    if (rate != priv->max_update_rate) {
+        priv->max_update_rate = rate;
+        /* Apply any pending value and start over with the new rate */
+        if (priv->tick_id != 0 || priv->timeout_id != 0) {
+            agw_numeric_label_update_text(label);
+        }
+        g_object_notify_by_pspec(G_OBJECT(label), props[PROP_MAX_UPDATE_RATE]);
+    }
+}
+
+/**
+ * agw_numeric_label_get_max_update_rate:
+ * @label: an #AgwNumericLabel
+ *
+ * Gets the maximum number of text updates per second.
+ *
+ * @return: the maximum update rate, 0 if not limited
+ **/
+gdouble
+agw_numeric_label_get_max_update_rate(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_NUMERIC_LABEL(label), 0);
+
+    priv = agw_numeric_label_get_instance_private(label);
+    return priv->max_update_rate;
+}
+
+/**
+ * agw_numeric_label_set_stable:
+ * @label: an #AgwNumericLabel
+ * @stable: whether to enable the stable mode
+ *
+ * Enables or disables the stable mode. When enabled, @label reserves
+ * the width of the widest text (see agw_numeric_label_set_range()) and
+ * uses tabular digits, so a value change only queues a redraw instead
+ * of resizing the label and reallocating its containers. The reserved
+ * width grows, with a single resize, when a wider text is shown.
+ *
+ * The `GtkLabel` text, its selection and its accessible name reflect
+ * the reserving text, not the value, in this mode.
+ **/
+void
+agw_numeric_label_set_stable(AgwNumericLabel *label, gboolean stable)
+{
+    AgwNumericLabelPrivate *priv;
+    GtkLabel *gtk_label;
+    PangoAttrList *attrs;
+
+    g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
+
+    priv = agw_numeric_label_get_instance_private(label);
+    stable = stable != FALSE;
+    if (stable == priv->stable) {
+        return;
+    }
+
+    gtk_label = GTK_LABEL(label);
+    priv->stable = stable;
+
+    if (stable) {
+        /* Keep the attributes set by the user, adding tabular digits */
+        attrs = gtk_label_get_attributes(gtk_label);
+        priv->user_attrs = attrs != NULL ? pango_attr_list_ref(attrs) : NULL;
+        priv->attrs = attrs != NULL ? pango_attr_list_copy(attrs) : pango_attr_list_new();
+        pango_attr_list_insert(priv->attrs, pango_attr_font_features_new("tnum 1"));
+        gtk_label_set_attributes(gtk_label, priv->attrs);
+        reserve_width(label);
+    } else {
+        drop_rendering(label);
+        gtk_label_set_attributes(gtk_label, priv->user_attrs);
+        g_clear_pointer(&priv->attrs, pango_attr_list_unref);
+        g_clear_pointer(&priv->user_attrs, pango_attr_list_unref);
+    }
+
+    agw_numeric_label_update_text(label);
+    g_object_notify_by_pspec(G_OBJECT(label), props[PROP_STABLE]);
+}
+
+/**
+ * agw_numeric_label_get_stable:
+ * @label: an #AgwNumericLabel
+ *
+ * Checks whether the stable mode is enabled.
+ *
+ * @return: %TRUE if @label reserves the width of the widest text
+ **/
+gboolean
+agw_numeric_label_get_stable(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_NUMERIC_LABEL(label), FALSE);
+
+    priv = agw_numeric_label_get_instance_private(label);
+    return priv->stable;
+}
+
+/**
+ * agw_numeric_label_set_range:
+ * @label: an #AgwNumericLabel
+ * @lower: lowest expected value
+ * @upper: highest expected value
+ *
+ * Declares the range of the values shown by @label. In stable mode the
+ * width reserved is the one of the widest between @lower and @upper,
+ * formatted with the current format. If @lower is not less than
+ * @upper (e.g. both 0, the default) no range is declared and the width
+ * of the widest text shown so far is reserved instead.
+ *
+ * The value itself is not clamped.
+ **/
+void
+agw_numeric_label_set_range(AgwNumericLabel *label, gdouble lower, gdouble upper)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
+
+    priv = agw_numeric_label_get_instance_private(label);
+    if (lower == priv->lower && upper == priv->upper) {
+        return;
+    }
+
+    g_object_freeze_notify(G_OBJECT(label));
+    if (lower != priv->lower) {
+        priv->lower = lower;
+        g_object_notify_by_pspec(G_OBJECT(label), props[PROP_LOWER]);
+    }
+    if (upper != priv->upper) {
+        priv->upper = upper;
+        g_object_notify_by_pspec(G_OBJECT(label), props[PROP_UPPER]);
+    }
+    if (priv->stable) {
+        reserve_width(label);
+        agw_numeric_label_update_text(label);
+    }
+    g_object_thaw_notify(G_OBJECT(label));
+}
+
+/**
+ * agw_numeric_label_get_range:
+ * @label: an #AgwNumericLabel
+ * @lower: (out) (optional): where to store the lowest expected value
+ * @upper: (out) (optional): where to store the highest expected value
+ *
+ * Gets the range set by agw_numeric_label_set_range().
+ **/
+void
+agw_numeric_label_get_range(AgwNumericLabel *label, gdouble *lower, gdouble *upper)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
+
+    priv = agw_numeric_label_get_instance_private(label);
+    if (lower != NULL) {
+        *lower = priv->lower;
+    }
+    if (upper != NULL) {
+        *upper = priv->upper;
+    }
+}
+
+/**
+ * agw_numeric_label_set_glyph_cache:
+ * @label: an #AgwNumericLabel
+ * @glyph_cache: whether to use the glyph cache
+ *
+ * Enables or disables the glyph cache. The glyphs of digits, signs,
+ * decimal points, exponents and of the literal text of the format are
+ * shaped once for the current font, and any text composed only of
+ * them is drawn with cairo_show_glyphs(), without Pango. Other texts
+ * fall back to a `PangoLayout`.
+ *
+ * This only applies in stable mode (see agw_numeric_label_set_stable()),
+ * where the value is drawn by @label itself.
+ **/
+void
+agw_numeric_label_set_glyph_cache(AgwNumericLabel *label, gboolean glyph_cache)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
+
+    priv = agw_numeric_label_get_instance_private(label);
+    glyph_cache = glyph_cache != FALSE;
+    if (glyph_cache == priv->glyph_cache) {
+        return;
+    }
+
+    priv->glyph_cache = glyph_cache;
+    if (priv->stable) {
+        drop_rendering(label);
+        agw_numeric_label_update_text(label);
+    }
+    g_object_notify_by_pspec(G_OBJECT(label), props[PROP_GLYPH_CACHE]);
+}
+
+/**
+ * agw_numeric_label_get_glyph_cache:
+ * @label: an #AgwNumericLabel
+ *
+ * Checks whether the glyph cache is enabled.
+ *
+ * @return: %TRUE if the glyph cache is enabled
+ **/
+gboolean
+agw_numeric_label_get_glyph_cache(AgwNumericLabel *label)
+{
+    AgwNumericLabelPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_NUMERIC_LABEL(label), FALSE);
+
+    priv = agw_numeric_label_get_instance_private(label);
+    return priv->glyph_cache;
+}
+
 /**
  * agw_numeric_label_update_text:
  * @label: an #AgwNumericLabel
  *
  * Updates the text according to the numeric label value and format
- * properties. This method is seldomly useful outside of
+ * properties, cancelling any update delayed by
+ * #AgwNumericLabel:max-update-rate. The label is not touched (and no
+ * relayout happens) if the text did not change, e.g. when the value
+ * changed less than the displayed precision, and in stable mode a new
+ * text just queues a redraw. This method is seldom useful outside of
  * #AgwNumericLabel subclasses.
  **/
 void
 agw_numeric_label_update_text(AgwNumericLabel *label)
 {
     AgwNumericLabelPrivate *priv;
+    gchar buffer[AGW_NUMERIC_FORMAT_BUFFER];
     gchar *text;
+    gint64 begin;
 
     g_return_if_fail(AGW_IS_NUMERIC_LABEL(label));
 
+    begin = agw_perf_begin();
     priv = agw_numeric_label_get_instance_private(label);
-    text = g_strdup_printf(priv->format, priv->value);
-    gtk_label_set_label(GTK_LABEL(label), text);
-    g_free(text);
+    cancel_update(label);
+
+    text = format_value(label, priv->value, buffer);
+    set_text(label, text);
+
+    if (text != buffer) {
+        g_free(text);
+    }
+    agw_perf_end(AGW_PERF_LABEL_UPDATE, label, begin, "AgwNumericLabel.update_text");
 }
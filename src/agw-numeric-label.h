@@ -36,6 +36,25 @@ const gchar *   agw_numeric_label_get_format    (AgwNumericLabel *  label);
 void            agw_numeric_label_set_value     (AgwNumericLabel *  label,
                                                  gdouble            value);
 gdouble         agw_numeric_label_get_value     (AgwNumericLabel *  label);
+void            agw_numeric_label_set_max_update_rate
+                                                (AgwNumericLabel *  label,
+                                                 gdouble            rate);
+gdouble         agw_numeric_label_get_max_update_rate
+                                                (AgwNumericLabel *  label);
+void            agw_numeric_label_set_stable    (AgwNumericLabel *  label,
+                                                 gboolean           stable);
+gboolean        agw_numeric_label_get_stable    (AgwNumericLabel *  label);
+void            agw_numeric_label_set_range     (AgwNumericLabel *  label,
+                                                 gdouble            lower,
+                                                 gdouble            upper);
+void            agw_numeric_label_get_range     (AgwNumericLabel *  label,
+                                                 gdouble *          lower,
+                                                 gdouble *          upper);
+void            agw_numeric_label_set_glyph_cache
+                                                (AgwNumericLabel *  label,
+                                                 gboolean           glyph_cache);
+gboolean        agw_numeric_label_get_glyph_cache
+                                                (AgwNumericLabel *  label);
 void            agw_numeric_label_update_text   (AgwNumericLabel *  label);
 
 G_END_DECLS
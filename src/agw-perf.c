@@ -0,0 +1,258 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Runtime instrumentation, enabled by setting the AGW_DEBUG environment
+ * variable to "perf" (or "all").
+ *
+ * When enabled, the widgets record timings and counters both globally
+ * and per object (in the object qdata) and, if libagw has been built
+ * with sysprof support, every timed event is also emitted as a sysprof
+ * mark. g_trace_mark() would be the natural choice, but it is private
+ * to GLib, so sysprof-capture is used directly. When disabled, every
+ * instrumentation point costs a single branch.
+ */
+
+#include "agw.h"
+#include "agw-perf.h"
+#include <string.h>
+#ifdef HAVE_SYSPROF
+#include <sysprof-capture.h>
+#endif
+
+
+typedef struct {
+    guint64             count;
+    gint64              time;
+    gint64              max;
+} AgwPerfEntry;
+
+
+static const GDebugKey debug_keys[] = {
+    { "perf", AGW_DEBUG_PERF },
+};
+
+/* Protects the global and the per-object entries: theme loads can be
+ * recorded from worker threads */
+G_LOCK_DEFINE_STATIC(perf);
+static AgwPerfEntry global[AGW_PERF_LAST];
+
+
+static GQuark
+get_quark(void)
+{
+    static GQuark quark = 0;
+
+    if (G_UNLIKELY(quark == 0)) {
+        quark = g_quark_from_static_string("agw-perf-stats");
+    }
+
+    return quark;
+}
+
+static void
+entry_add(AgwPerfEntry *entry, gint64 elapsed)
+{
+    ++entry->count;
+    entry->time += elapsed;
+    entry->max = MAX(entry->max, elapsed);
+}
+
+static void
+record(AgwPerfCounter counter, gpointer object, gint64 elapsed)
+{
+    AgwPerfEntry *entries;
+
+    G_LOCK(perf);
+    entry_add(&global[counter], elapsed);
+    if (object != NULL) {
+        entries = g_object_get_qdata(object, get_quark());
+        if (entries == NULL) {
+            entries = g_new0(AgwPerfEntry, AGW_PERF_LAST);
+            g_object_set_qdata_full(object, get_quark(), entries, g_free);
+        }
+        entry_add(&entries[counter], elapsed);
+    }
+    G_UNLOCK(perf);
+}
+
+static void
+fill_stats(AgwStats *dst, const AgwPerfEntry *src)
+{
+    dst->draws               = src[AGW_PERF_DRAW].count;
+    dst->draw_time           = src[AGW_PERF_DRAW].time;
+    dst->draw_time_max       = src[AGW_PERF_DRAW].max;
+    dst->redraws             = src[AGW_PERF_REDRAW].count;
+    dst->theme_loads         = src[AGW_PERF_THEME_LOAD].count;
+    dst->theme_load_time     = src[AGW_PERF_THEME_LOAD].time;
+    dst->theme_cache_hits    = src[AGW_PERF_THEME_HIT].count;
+    dst->theme_cache_misses  = src[AGW_PERF_THEME_MISS].count;
+    dst->layers_cache_hits   = src[AGW_PERF_LAYERS_HIT].count;
+    dst->layers_cache_misses = src[AGW_PERF_LAYERS_MISS].count;
+    dst->label_updates       = src[AGW_PERF_LABEL_UPDATE].count;
+    dst->label_update_time   = src[AGW_PERF_LABEL_UPDATE].time;
+}
+
+
+/*
+ * agw_get_debug_flags:
+ *
+ * Gets the flags parsed from the AGW_DEBUG environment variable.
+ *
+ * Returns: a combination of #AgwDebugFlags
+ */
+guint
+agw_get_debug_flags(void)
+{
+    static gsize flags = 0;
+
+    if (g_once_init_enter(&flags)) {
+        /* Offset by one, as g_once_init_leave() does not accept 0 */
+        guint parsed = g_parse_debug_string(g_getenv("AGW_DEBUG"),
+                                            debug_keys,
+                                            G_N_ELEMENTS(debug_keys));
+        g_once_init_leave(&flags, parsed + 1);
+    }
+
+    return flags - 1;
+}
+
+/*
+ * agw_perf_begin:
+ *
+ * Starts timing an event.
+ *
+ * Returns: the value to pass to agw_perf_end(), 0 if the
+ *          instrumentation is disabled
+ */
+gint64
+agw_perf_begin(void)
+{
+    return AGW_PERF_ENABLED() ? g_get_monotonic_time() : 0;
+}
+
+/*
+ * agw_perf_end:
+ * @counter: the timed #AgwPerfCounter
+ * @object: (allow-none): the object the event refers to
+ * @begin: the value returned by agw_perf_begin()
+ * @name: name of the sysprof mark
+ *
+ * Stops timing an event, recording its duration globally and in
+ * @object. Nothing is done if @begin is 0.
+ */
+void
+agw_perf_end(AgwPerfCounter counter, gpointer object, gint64 begin, const gchar *name)
+{
+    gint64 elapsed;
+
+    if (begin == 0) {
+        return;
+    }
+
+    elapsed = g_get_monotonic_time() - begin;
+    record(counter, object, elapsed);
+
+#ifdef HAVE_SYSPROF
+    /* Both clocks are CLOCK_MONOTONIC: sysprof wants nanoseconds */
+    sysprof_collector_mark(begin * 1000, elapsed * 1000, "libagw", name,
+                           object != NULL ? G_OBJECT_TYPE_NAME(object) : NULL);
+#endif
+}
+
+/*
+ * agw_perf_count:
+ * @counter: the #AgwPerfCounter to increment
+ * @object: (allow-none): the object the event refers to
+ *
+ * Increments @counter, globally and in @object, if the
+ * instrumentation is enabled.
+ */
+void
+agw_perf_count(AgwPerfCounter counter, gpointer object)
+{
+    if (AGW_PERF_ENABLED()) {
+        record(counter, object, 0);
+    }
+}
+
+
+/**
+ * agw_get_stats:
+ * @stats: (out caller-allocates): where to store the statistics
+ *
+ * Gets the performance counters aggregated over the whole process.
+ * Counters are collected only when the `AGW_DEBUG` environment
+ * variable contains `perf`, e.g. `AGW_DEBUG=perf ./myapp`.
+ *
+ * @return: FALSE if the instrumentation is disabled, in which case
+ *          @stats is zeroed.
+ **/
+gboolean
+agw_get_stats(AgwStats *stats)
+{
+    g_return_val_if_fail(stats != NULL, FALSE);
+
+    G_LOCK(perf);
+    fill_stats(stats, global);
+    G_UNLOCK(perf);
+
+    return AGW_PERF_ENABLED();
+}
+
+/**
+ * agw_get_widget_stats:
+ * @widget: a #GtkWidget
+ * @stats: (out caller-allocates): where to store the statistics
+ *
+ * Gets the performance counters of a single widget. See
+ * agw_get_stats() for details.
+ *
+ * @return: FALSE if the instrumentation is disabled or nothing has
+ *          been recorded for @widget, in which case @stats is zeroed.
+ **/
+gboolean
+agw_get_widget_stats(GtkWidget *widget, AgwStats *stats)
+{
+    static const AgwPerfEntry empty[AGW_PERF_LAST] = { { 0 } };
+    const AgwPerfEntry *entries;
+
+    g_return_val_if_fail(GTK_IS_WIDGET(widget), FALSE);
+    g_return_val_if_fail(stats != NULL, FALSE);
+
+    G_LOCK(perf);
+    entries = g_object_get_qdata(G_OBJECT(widget), get_quark());
+    fill_stats(stats, entries != NULL ? entries : empty);
+    G_UNLOCK(perf);
+
+    return entries != NULL;
+}
+
+/**
+ * agw_reset_stats:
+ *
+ * Resets the process-wide performance counters. The counters of the
+ * single widgets are not affected.
+ **/
+void
+agw_reset_stats(void)
+{
+    G_LOCK(perf);
+    memset(global, 0, sizeof(global));
+    G_UNLOCK(perf);
+}
@@ -0,0 +1,64 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Private header: not installed and not part of the public API */
+
+#ifndef __AGW_PERF_H__
+#define __AGW_PERF_H__
+
+#include <glib-object.h>
+
+
+G_BEGIN_DECLS
+
+typedef enum {
+    AGW_DEBUG_PERF = 1 << 0,
+} AgwDebugFlags;
+
+typedef enum {
+    /* Timed events */
+    AGW_PERF_DRAW,
+    AGW_PERF_THEME_LOAD,
+    AGW_PERF_LABEL_UPDATE,
+    /* Plain counters */
+    AGW_PERF_REDRAW,
+    AGW_PERF_THEME_HIT,
+    AGW_PERF_THEME_MISS,
+    AGW_PERF_LAYERS_HIT,
+    AGW_PERF_LAYERS_MISS,
+    AGW_PERF_LAST,
+} AgwPerfCounter;
+
+/* Cheap enough to be used in the hot paths: a single branch when the
+ * instrumentation is disabled */
+#define AGW_PERF_ENABLED()  G_UNLIKELY(agw_get_debug_flags() & AGW_DEBUG_PERF)
+
+
+guint           agw_get_debug_flags         (void);
+gint64          agw_perf_begin              (void);
+void            agw_perf_end                (AgwPerfCounter     counter,
+                                             gpointer           object,
+                                             gint64             begin,
+                                             const gchar *      name);
+void            agw_perf_count              (AgwPerfCounter     counter,
+                                             gpointer           object);
+
+G_END_DECLS
+
+
+#endif /* __AGW_PERF_H__ */
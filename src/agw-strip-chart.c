@@ -0,0 +1,824 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * SECTION:agw-strip-chart
+ * @short_description: A `GtkRange` based scrolling history
+ *
+ * #AgwStripChart shows how a value changed during the last
+ * #AgwStripChart:duration seconds, the newest value on the right. As
+ * for #AgwGauge, the limits of the vertical axis are the lower and
+ * upper values of the underlying `GtkAdjustment` and the `inverted`
+ * property puts the upper value at the bottom.
+ *
+ * Every value set with gtk_range_set_value() is added to the history,
+ * but high rate sources should use agw_strip_chart_push() that does
+ * not emit any signal. The samples are kept, with the time they were
+ * pushed at, in a ring buffer of #AgwStripChart:capacity samples.
+ *
+ * Each pixel column covers a slice of time and is drawn as a vertical
+ * segment spanning the minimum and maximum value of that slice (and
+ * the last value of the previous one, so the segments join). The
+ * slices are computed while pushing, so the cost of drawing does not
+ * depend on how many samples they contain. The columns are cached in
+ * a surface used as a circular buffer: on every frame only the columns
+ * completed since the previous one are drawn, the rest of the history
+ * is just blitted at its new position. The whole history is processed
+ * again only when the size, the limits, the duration or the style
+ * change.
+ **/
+
+/**
+ * AgwStripChart:
+ *
+ * All fields are private and should not be used directly.
+ * Use its public methods instead.
+ **/
+
+#include "agw-strip-chart.h"
+#include "agw-perf.h"
+#include <math.h>
+
+
+/* A pixel column of the history */
+typedef struct {
+    gint64              column;
+    gdouble             lo;
+    gdouble             hi;
+    gdouble             last;
+} AgwStripColumn;
+
+typedef struct {
+    /* Ring buffer of the raw samples */
+    gint64 *            times;
+    gdouble *           values;
+    guint               capacity;
+    guint               head;
+    guint               count;
+
+    gdouble             duration;
+
+    /* Decimation: microseconds per pixel column, 0 if not allocated */
+    gdouble             column_time;
+    /* Completed columns not drawn yet, oldest first (ring of
+     * n_columns elements, as older ones are out of sight anyway) */
+    AgwStripColumn *    pending;
+    gint                n_columns;
+    guint               pending_head;
+    guint               n_pending;
+    /* The column the newest samples are folded into */
+    AgwStripColumn      current;
+    gboolean            has_current;
+    gdouble             last;
+    gboolean            has_last;
+
+    /* Circular cache of the drawn columns: column c is at c % n_columns */
+    cairo_surface_t *   surface;
+    gint64              drawn_column;
+    gdouble             hold;
+    gboolean            has_hold;
+    gint64              shown_column;
+    gboolean            dirty;
+    GdkRGBA             color;
+    guint               tick_id;
+
+    GtkAdjustment *     adjustment;
+    gulong              changed_id;
+} AgwStripChartPrivate;
+
+struct _AgwStripChart {
+    GtkRange parent_instance;
+};
+
+enum {
+    PROP_0,
+    PROP_DURATION,
+    PROP_CAPACITY,
+    NUM_PROPERTIES,
+};
+
+static GParamSpec *props[NUM_PROPERTIES] = { 0 };
+
+
+G_DEFINE_TYPE_WITH_PRIVATE(AgwStripChart, agw_strip_chart, GTK_TYPE_RANGE)
+
+
+static gint64
+get_column(AgwStripChartPrivate *priv, gint64 time)
+{
+    return (gint64) floor(time / priv->column_time);
+}
+
+/* Position of @column in the circular surface */
+static gint
+get_x(AgwStripChartPrivate *priv, gint64 column)
+{
+    gint64 x = column % priv->n_columns;
+    return x < 0 ? x + priv->n_columns : x;
+}
+
+static void
+flush_current(AgwStripChartPrivate *priv)
+{
+    AgwStripColumn *slot;
+
+    if (priv->n_pending == (guint) priv->n_columns) {
+        /* Drop the oldest column: it would be out of sight */
+        priv->pending_head = (priv->pending_head + 1) % priv->n_columns;
+        --priv->n_pending;
+    }
+
+    slot = &priv->pending[(priv->pending_head + priv->n_pending) % priv->n_columns];
+    *slot = priv->current;
+    ++priv->n_pending;
+    priv->has_current = FALSE;
+}
+
+static void
+fold(AgwStripChartPrivate *priv, gint64 time, gdouble value)
+{
+    AgwStripColumn *current = &priv->current;
+    gint64 column = get_column(priv, time);
+
+    if (priv->has_current && column <= current->column) {
+        current->lo = MIN(current->lo, value);
+        current->hi = MAX(current->hi, value);
+        current->last = value;
+    } else {
+        if (priv->has_current) {
+            flush_current(priv);
+        }
+        current->column = column;
+        current->lo = current->hi = value;
+        if (priv->has_last) {
+            /* Join with the previous value */
+            current->lo = MIN(current->lo, priv->last);
+            current->hi = MAX(current->hi, priv->last);
+        }
+        current->last = value;
+        priv->has_current = TRUE;
+    }
+
+    priv->last = value;
+    priv->has_last = TRUE;
+}
+
+static gboolean
+scroll(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+    AgwStripChart *chart = AGW_STRIP_CHART(widget);
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    gint64 now_column;
+
+    now_column = get_column(priv, gdk_frame_clock_get_frame_time(frame_clock));
+    if (priv->dirty || now_column != priv->shown_column) {
+        agw_perf_count(AGW_PERF_REDRAW, chart);
+        gtk_widget_queue_draw(widget);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+/* The chart scrolls only while it is mapped and has a time scale:
+ * otherwise no tick callback keeps the frame clock running */
+static void
+update_tick(AgwStripChart *chart)
+{
+    GtkWidget *widget = GTK_WIDGET(chart);
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    gboolean scrolling = priv->column_time > 0 && gtk_widget_get_mapped(widget);
+
+    if (scrolling && priv->tick_id == 0) {
+        priv->tick_id = gtk_widget_add_tick_callback(widget, scroll, NULL, NULL);
+    } else if (!scrolling && priv->tick_id != 0) {
+        gtk_widget_remove_tick_callback(widget, priv->tick_id);
+        priv->tick_id = 0;
+    }
+}
+
+/* Decimates the whole history again and drops the cached columns */
+static void
+rebuild(AgwStripChart *chart)
+{
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    gint width = gtk_widget_get_allocated_width(GTK_WIDGET(chart));
+    guint n, index;
+
+    g_clear_pointer(&priv->surface, cairo_surface_destroy);
+    g_free(priv->pending);
+    priv->pending = NULL;
+    priv->pending_head = 0;
+    priv->n_pending = 0;
+    priv->has_current = FALSE;
+    priv->has_last = FALSE;
+    priv->has_hold = FALSE;
+    priv->drawn_column = G_MININT64;
+    priv->dirty = TRUE;
+
+    if (width <= 1) {
+        priv->n_columns = 0;
+        priv->column_time = 0;
+        update_tick(chart);
+        return;
+    }
+
+    priv->n_columns = width;
+    priv->column_time = priv->duration * G_USEC_PER_SEC / width;
+    priv->pending = g_new(AgwStripColumn, width);
+    update_tick(chart);
+
+    index = (priv->head + priv->capacity - priv->count) % priv->capacity;
+    for (n = 0; n < priv->count; ++n) {
+        fold(priv, priv->times[index], priv->values[index]);
+        index = (index + 1) % priv->capacity;
+    }
+
+    gtk_widget_queue_draw(GTK_WIDGET(chart));
+}
+
+static gdouble
+get_y(AgwStripChart *chart, gdouble value, gint height)
+{
+    GtkAdjustment *adjustment = gtk_range_get_adjustment(GTK_RANGE(chart));
+    gdouble lower, upper, ratio;
+
+    lower = gtk_adjustment_get_lower(adjustment);
+    upper = gtk_adjustment_get_upper(adjustment);
+    ratio = upper > lower ? (value - lower) / (upper - lower) : 0.5;
+    ratio = CLAMP(ratio, 0, 1);
+    if (!gtk_range_get_inverted(GTK_RANGE(chart))) {
+        ratio = 1 - ratio;
+    }
+
+    return ratio * height;
+}
+
+static void
+draw_segment(AgwStripChart *chart, cairo_t *cr, gint x, gdouble lo, gdouble hi, gint height)
+{
+    gdouble y1 = get_y(chart, lo, height);
+    gdouble y2 = get_y(chart, hi, height);
+    gdouble top = floor(MIN(y1, y2));
+    gdouble bottom = ceil(MAX(y1, y2));
+
+    cairo_rectangle(cr, x, top, 1, MAX(bottom - top, 1));
+}
+
+/* Draws into the cache the columns completed before @now_column */
+static void
+update_surface(AgwStripChart *chart, gint64 now_column, gint height)
+{
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    AgwStripColumn *column;
+    cairo_t *cr;
+    gint64 c;
+    gint x, n;
+    gboolean drawn;
+
+    if (priv->has_current && priv->current.column < now_column) {
+        flush_current(priv);
+    }
+
+    c = now_column - priv->n_columns;
+    if (priv->drawn_column != G_MININT64) {
+        c = MAX(c, priv->drawn_column + 1);
+    }
+    if (c >= now_column) {
+        return;
+    }
+
+    cr = cairo_create(priv->surface);
+
+    /* Clear the new columns: in the circular surface they can wrap */
+    n = now_column - c;
+    x = get_x(priv, c);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_rectangle(cr, x, 0, MIN(n, priv->n_columns - x), height);
+    if (x + n > priv->n_columns) {
+        cairo_rectangle(cr, 0, 0, x + n - priv->n_columns, height);
+    }
+    cairo_fill(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    for (; c < now_column; ++c) {
+        x = get_x(priv, c);
+        drawn = FALSE;
+
+        /* Older columns are out of sight: only their last value matters */
+        while (priv->n_pending > 0 && priv->pending[priv->pending_head].column <= c) {
+            column = &priv->pending[priv->pending_head];
+            priv->pending_head = (priv->pending_head + 1) % priv->n_columns;
+            --priv->n_pending;
+            priv->hold = column->last;
+            priv->has_hold = TRUE;
+            if (column->column == c) {
+                draw_segment(chart, cr, x, column->lo, column->hi, height);
+                drawn = TRUE;
+            }
+        }
+
+        /* No samples in this column: hold the last value */
+        if (!drawn && priv->has_hold) {
+            draw_segment(chart, cr, x, priv->hold, priv->hold, height);
+        }
+    }
+
+    gdk_cairo_set_source_rgba(cr, &priv->color);
+    cairo_fill(cr);
+    cairo_destroy(cr);
+
+    priv->drawn_column = now_column - 1;
+}
+
+static void
+render(GtkWidget *widget, cairo_t *cr)
+{
+    AgwStripChart *chart = AGW_STRIP_CHART(widget);
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    GtkStyleContext *context = gtk_widget_get_style_context(widget);
+    GdkFrameClock *frame_clock;
+    gint width, height, k;
+    gint64 now, now_column;
+
+    width = gtk_widget_get_allocated_width(widget);
+    height = gtk_widget_get_allocated_height(widget);
+    gtk_render_background(context, cr, 0, 0, width, height);
+
+    if (priv->n_columns != width || height <= 0) {
+        /* Not decimated for this size yet */
+        return;
+    }
+
+    frame_clock = gtk_widget_get_frame_clock(widget);
+    now = frame_clock != NULL ? gdk_frame_clock_get_frame_time(frame_clock) :
+                                g_get_monotonic_time();
+    now_column = get_column(priv, now);
+
+    if (priv->surface == NULL) {
+        /* Fully transparent, as required by update_surface() */
+        priv->surface = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
+                                                          CAIRO_CONTENT_COLOR_ALPHA,
+                                                          width, height);
+    }
+    update_surface(chart, now_column, height);
+
+    /* The newest column is on the right: the surface is blitted in two
+     * pieces, the one after @now_column (older) and the one before */
+    k = get_x(priv, now_column);
+    cairo_save(cr);
+    cairo_rectangle(cr, 0, 0, width - 1 - k, height);
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, priv->surface, -k - 1, 0);
+    cairo_paint(cr);
+    cairo_restore(cr);
+
+    cairo_save(cr);
+    cairo_rectangle(cr, width - 1 - k, 0, k, height);
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, priv->surface, width - 1 - k, 0);
+    cairo_paint(cr);
+    cairo_restore(cr);
+
+    /* The column still being filled is not cached */
+    if (priv->has_current && priv->current.column >= now_column) {
+        draw_segment(chart, cr, width - 1, priv->current.lo, priv->current.hi, height);
+    } else if (priv->has_last) {
+        draw_segment(chart, cr, width - 1, priv->last, priv->last, height);
+    }
+    gdk_cairo_set_source_rgba(cr, &priv->color);
+    cairo_fill(cr);
+
+    priv->shown_column = now_column;
+    priv->dirty = FALSE;
+}
+
+static gboolean
+draw(GtkWidget *widget, cairo_t *cr)
+{
+    gint64 begin = agw_perf_begin();
+
+    render(widget, cr);
+    agw_perf_end(AGW_PERF_DRAW, widget, begin, "AgwStripChart.draw");
+
+    return FALSE;
+}
+
+static void
+map(GtkWidget *widget)
+{
+    GTK_WIDGET_CLASS(agw_strip_chart_parent_class)->map(widget);
+    update_tick(AGW_STRIP_CHART(widget));
+}
+
+static void
+unmap(GtkWidget *widget)
+{
+    GTK_WIDGET_CLASS(agw_strip_chart_parent_class)->unmap(widget);
+    update_tick(AGW_STRIP_CHART(widget));
+}
+
+static void
+get_preferred_width(GtkWidget *widget, gint *minimum, gint *natural)
+{
+    *minimum = 64;
+    *natural = 300;
+}
+
+static void
+get_preferred_height(GtkWidget *widget, gint *minimum, gint *natural)
+{
+    *minimum = 32;
+    *natural = 100;
+}
+
+static void
+size_allocate(GtkWidget *widget, GtkAllocation *allocation)
+{
+    GtkAllocation old;
+
+    gtk_widget_get_allocation(widget, &old);
+    GTK_WIDGET_CLASS(agw_strip_chart_parent_class)->size_allocate(widget, allocation);
+
+    /* redraw-on-allocate is disabled: moving the chart keeps the cache */
+    if (old.width != allocation->width || old.height != allocation->height) {
+        rebuild(AGW_STRIP_CHART(widget));
+    } else if (old.x != allocation->x || old.y != allocation->y) {
+        gtk_widget_queue_draw(widget);
+    }
+}
+
+static void
+style_updated(GtkWidget *widget)
+{
+    AgwStripChart *chart = AGW_STRIP_CHART(widget);
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    GtkStyleContext *context = gtk_widget_get_style_context(widget);
+    GdkRGBA color;
+
+    GTK_WIDGET_CLASS(agw_strip_chart_parent_class)->style_updated(widget);
+
+    /* The cache must be redrawn only if the color changed, not e.g.
+     * on every prelight change */
+    gtk_style_context_get_color(context, gtk_style_context_get_state(context), &color);
+    if (!gdk_rgba_equal(&color, &priv->color)) {
+        priv->color = color;
+        rebuild(chart);
+    }
+}
+
+static void
+value_changed(GtkRange *range)
+{
+    agw_strip_chart_push(AGW_STRIP_CHART(range), gtk_range_get_value(range));
+}
+
+static void
+track_adjustment(AgwStripChart *chart)
+{
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+    GtkAdjustment *adjustment = gtk_range_get_adjustment(GTK_RANGE(chart));
+
+    if (adjustment == priv->adjustment) {
+        return;
+    }
+
+    if (priv->adjustment != NULL) {
+        g_signal_handler_disconnect(priv->adjustment, priv->changed_id);
+        g_object_unref(priv->adjustment);
+    }
+
+    priv->adjustment = adjustment;
+    priv->changed_id = 0;
+    if (adjustment == NULL) {
+        return;
+    }
+
+    /* New limits move the whole history */
+    g_object_ref_sink(adjustment);
+    priv->changed_id = g_signal_connect_swapped(adjustment, "changed",
+                                                G_CALLBACK(rebuild), chart);
+}
+
+static void
+range_notify(AgwStripChart *chart, GParamSpec *pspec, gpointer user_data)
+{
+    track_adjustment(chart);
+    rebuild(chart);
+}
+
+static void
+finalize(GObject *object)
+{
+    AgwStripChart *chart = AGW_STRIP_CHART(object);
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+
+    if (priv->adjustment != NULL) {
+        g_signal_handler_disconnect(priv->adjustment, priv->changed_id);
+        g_clear_object(&priv->adjustment);
+    }
+    g_clear_pointer(&priv->surface, cairo_surface_destroy);
+    g_free(priv->pending);
+    g_free(priv->times);
+    g_free(priv->values);
+
+    G_OBJECT_CLASS(agw_strip_chart_parent_class)->finalize(object);
+}
+
+static void
+get_property(GObject *object, guint prop_id,
+             GValue *value, GParamSpec *pspec)
+{
+    AgwStripChart *chart = AGW_STRIP_CHART(object);
+
+    switch (prop_id) {
+    case PROP_DURATION:
+        g_value_set_double(value, agw_strip_chart_get_duration(chart));
+        break;
+    case PROP_CAPACITY:
+        g_value_set_uint(value, agw_strip_chart_get_capacity(chart));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+set_property(GObject *object, guint prop_id,
+             const GValue *value, GParamSpec *pspec)
+{
+    AgwStripChart *chart = AGW_STRIP_CHART(object);
+
+    switch (prop_id) {
+    case PROP_DURATION:
+        agw_strip_chart_set_duration(chart, g_value_get_double(value));
+        break;
+    case PROP_CAPACITY:
+        agw_strip_chart_set_capacity(chart, g_value_get_uint(value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+agw_strip_chart_class_init(AgwStripChartClass *class)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(class);
+    GtkRangeClass *range_class = GTK_RANGE_CLASS(class);
+
+    object_class->finalize = finalize;
+    object_class->get_property = get_property;
+    object_class->set_property = set_property;
+
+    widget_class->get_preferred_width = get_preferred_width;
+    widget_class->get_preferred_height = get_preferred_height;
+    widget_class->map = map;
+    widget_class->unmap = unmap;
+    widget_class->size_allocate = size_allocate;
+    widget_class->style_updated = style_updated;
+    widget_class->draw = draw;
+
+    range_class->value_changed = value_changed;
+
+    props[PROP_DURATION] = g_param_spec_double("duration",
+                                               "Duration",
+                                               "Time span shown by the chart, in seconds",
+                                               0.001, G_MAXDOUBLE, 60,
+                                               G_PARAM_READWRITE);
+    props[PROP_CAPACITY] = g_param_spec_uint("capacity",
+                                             "Capacity",
+                                             "Maximum number of samples kept in the history",
+                                             2, G_MAXUINT / sizeof(gint64), 65536,
+                                             G_PARAM_READWRITE);
+
+    g_object_class_install_properties(object_class, NUM_PROPERTIES, props);
+}
+
+static void
+agw_strip_chart_init(AgwStripChart *chart)
+{
+    AgwStripChartPrivate *priv = agw_strip_chart_get_instance_private(chart);
+
+    gtk_widget_set_has_window(GTK_WIDGET(chart), FALSE);
+    gtk_widget_set_redraw_on_allocate(GTK_WIDGET(chart), FALSE);
+    g_signal_connect(chart, "notify::adjustment",
+                     G_CALLBACK(range_notify), NULL);
+    g_signal_connect(chart, "notify::inverted",
+                     G_CALLBACK(range_notify), NULL);
+    g_signal_connect(chart, "notify::scale-factor",
+                     G_CALLBACK(range_notify), NULL);
+
+    priv->capacity      = 65536;
+    priv->times         = g_new(gint64, priv->capacity);
+    priv->values        = g_new(gdouble, priv->capacity);
+    priv->head          = 0;
+    priv->count         = 0;
+    priv->duration      = 60;
+    priv->column_time   = 0;
+    priv->n_columns     = 0;
+    priv->pending       = NULL;
+    priv->surface       = NULL;
+    priv->drawn_column  = G_MININT64;
+    priv->tick_id       = 0;
+    priv->adjustment    = NULL;
+
+    track_adjustment(chart);
+}
+
+
+/**
+ * agw_strip_chart_new:
+ *
+ * Creates a new #AgwStripChart widget.
+ *
+ * Returns: the newly created widget
+ **/
+GtkWidget *
+agw_strip_chart_new(void)
+{
+    GtkWidget *widget = (GtkWidget *) g_object_new(AGW_TYPE_STRIP_CHART, NULL);
+    return widget;
+}
+
+/**
+ * agw_strip_chart_push:
+ * @chart: an #AgwStripChart
+ * @value: the new sample
+ *
+ * Adds @value to the history, timestamped with the current monotonic
+ * time. When the history is full, the oldest sample is dropped. Unlike
+ * gtk_range_set_value(), no signal is emitted and the value of the
+ * underlying `GtkAdjustment` is not changed, so this can be called at
+ * any rate: the chart is redrawn at most once per frame.
+ **/
+void
+agw_strip_chart_push(AgwStripChart *chart, gdouble value)
+{
+    AgwStripChartPrivate *priv;
+    gint64 time;
+
+    g_return_if_fail(AGW_IS_STRIP_CHART(chart));
+
+    priv = agw_strip_chart_get_instance_private(chart);
+    time = g_get_monotonic_time();
+
+    priv->times[priv->head] = time;
+    priv->values[priv->head] = value;
+    priv->head = (priv->head + 1) % priv->capacity;
+    if (priv->count < priv->capacity) {
+        ++priv->count;
+    }
+
+    if (priv->column_time > 0) {
+        fold(priv, time, value);
+    }
+    priv->dirty = TRUE;
+}
+
+/**
+ * agw_strip_chart_clear:
+ * @chart: an #AgwStripChart
+ *
+ * Removes all the samples from the history.
+ **/
+void
+agw_strip_chart_clear(AgwStripChart *chart)
+{
+    AgwStripChartPrivate *priv;
+
+    g_return_if_fail(AGW_IS_STRIP_CHART(chart));
+
+    priv = agw_strip_chart_get_instance_private(chart);
+    priv->head = 0;
+    priv->count = 0;
+    rebuild(chart);
+}
+
+/**
+ * agw_strip_chart_set_duration:
+ * @chart: an #AgwStripChart
+ * @duration: the time span to show, in seconds
+ *
+ * Sets how much history is shown, from the left to the right edge of
+ * @chart. Only the samples still in the history can be shown: choose
+ * #AgwStripChart:capacity accordingly to the sample rate.
+ **/
+void
+agw_strip_chart_set_duration(AgwStripChart *chart, gdouble duration)
+{
+    AgwStripChartPrivate *priv;
+
+    g_return_if_fail(AGW_IS_STRIP_CHART(chart));
+    g_return_if_fail(duration > 0);
+
+    priv = agw_strip_chart_get_instance_private(chart);
+    if (duration != priv->duration) {
+        priv->duration = duration;
+        rebuild(chart);
+        g_object_notify_by_pspec(G_OBJECT(chart), props[PROP_DURATION]);
+    }
+}
+
+/**
+ * agw_strip_chart_get_duration:
+ * @chart: an #AgwStripChart
+ *
+ * Gets the time span shown by @chart.
+ *
+ * @return: the duration in seconds
+ **/
+gdouble
+agw_strip_chart_get_duration(AgwStripChart *chart)
+{
+    AgwStripChartPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_STRIP_CHART(chart), 0);
+
+    priv = agw_strip_chart_get_instance_private(chart);
+    return priv->duration;
+}
+
+/**
+ * agw_strip_chart_set_capacity:
+ * @chart: an #AgwStripChart
+ * @capacity: maximum number of samples
+ *
+ * Sets how many samples are kept in the history. The newest samples
+ * are preserved. What is already on screen is not affected: the
+ * history is used only when the chart must be redrawn from scratch,
+ * e.g. after a resize.
+ **/
+void
+agw_strip_chart_set_capacity(AgwStripChart *chart, guint capacity)
+{
+    AgwStripChartPrivate *priv;
+    gint64 *times;
+    gdouble *values;
+    guint n, count, index;
+
+    g_return_if_fail(AGW_IS_STRIP_CHART(chart));
+    g_return_if_fail(capacity >= 2);
+
+    priv = agw_strip_chart_get_instance_private(chart);
+    if (capacity == priv->capacity) {
+        return;
+    }
+
+    /* Copy the newest samples, unwrapping the ring */
+    times = g_new(gint64, capacity);
+    values = g_new(gdouble, capacity);
+    count = MIN(priv->count, capacity);
+    index = (priv->head + priv->capacity - count) % priv->capacity;
+    for (n = 0; n < count; ++n) {
+        times[n] = priv->times[index];
+        values[n] = priv->values[index];
+        index = (index + 1) % priv->capacity;
+    }
+
+    g_free(priv->times);
+    g_free(priv->values);
+    priv->times = times;
+    priv->values = values;
+    priv->capacity = capacity;
+    priv->count = count;
+    priv->head = count % capacity;
+
+    g_object_notify_by_pspec(G_OBJECT(chart), props[PROP_CAPACITY]);
+}
+
+/**
+ * agw_strip_chart_get_capacity:
+ * @chart: an #AgwStripChart
+ *
+ * Gets the maximum number of samples kept in the history.
+ *
+ * @return: the capacity of the history
+ **/
+guint
+agw_strip_chart_get_capacity(AgwStripChart *chart)
+{
+    AgwStripChartPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_STRIP_CHART(chart), 0);
+
+    priv = agw_strip_chart_get_instance_private(chart);
+    return priv->capacity;
+}
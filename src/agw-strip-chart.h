@@ -0,0 +1,46 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __AGW_STRIP_CHART_H__
+#define __AGW_STRIP_CHART_H__
+
+#include <gtk/gtk.h>
+
+
+G_BEGIN_DECLS
+
+#define AGW_TYPE_STRIP_CHART agw_strip_chart_get_type()
+
+G_DECLARE_FINAL_TYPE(AgwStripChart, agw_strip_chart, AGW, STRIP_CHART, GtkRange)
+
+
+GtkWidget *     agw_strip_chart_new         (void);
+void            agw_strip_chart_push        (AgwStripChart *    chart,
+                                             gdouble            value);
+void            agw_strip_chart_clear       (AgwStripChart *    chart);
+void            agw_strip_chart_set_duration(AgwStripChart *    chart,
+                                             gdouble            duration);
+gdouble         agw_strip_chart_get_duration(AgwStripChart *    chart);
+void            agw_strip_chart_set_capacity(AgwStripChart *    chart,
+                                             guint              capacity);
+guint           agw_strip_chart_get_capacity(AgwStripChart *    chart);
+
+G_END_DECLS
+
+
+#endif /* __AGW_STRIP_CHART_H__ */
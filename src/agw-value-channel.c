@@ -0,0 +1,519 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * SECTION:agw-value-channel
+ * @short_description: Feeds widgets with values from other threads
+ *
+ * An #AgwValueChannel moves values from a producer thread to the GTK
+ * main thread without allocating, locking or queueing anything per
+ * value. The producer calls agw_value_channel_push() as often as it
+ * likes: the channel keeps only a summary (last, min, max, sum and
+ * count) of the values pushed since the consumer last looked at it.
+ *
+ * When a widget is bound with agw_value_channel_bind(), the summary is
+ * drained once per frame and a single value, selected by
+ * #AgwValueChannel:aggregate, is applied to the widget. The main loop
+ * work is hence bounded by the frame rate, regardless of how fast the
+ * values come in. While no value is pushed the channel does not wake up
+ * the main loop at all.
+ *
+ * The summary is protected by a sequence counter, that the consumer
+ * also uses to mark the summary as taken, so there must be only one
+ * producer thread per channel. Binding, unbinding and draining must
+ * be done from the main thread.
+ **/
+
+/**
+ * AgwValueChannel:
+ *
+ * All fields are private and should not be used directly.
+ * Use its public methods instead.
+ **/
+
+#include "agw-value-channel.h"
+#include "agw-gauge.h"
+#include "agw-numeric-label.h"
+
+
+/* A summary that cannot be read because it is being written is just
+ * left for the next frame after these attempts */
+#define DRAIN_ATTEMPTS  8
+
+/* Flags in the low bits of the sequence counter */
+#define SEQ_WRITING     1
+#define SEQ_DRAINED     2
+#define SEQ_FLAGS       (SEQ_WRITING | SEQ_DRAINED)
+#define SEQ_STEP        4
+
+
+typedef struct {
+    /* Advanced by SEQ_STEP by the producer after every write, with
+     * SEQ_WRITING set while the summary is inconsistent. The consumer
+     * sets SEQ_DRAINED with a compare and exchange when it takes the
+     * summary, so the producer cannot miss it and starts a new one */
+    gint                seq;
+    AgwValueSummary     summary;
+    /* TRUE while the consumer is going to look at the channel anyway,
+     * so the producer does not need to wake it up */
+    gint                armed;
+    AgwValueAggregate   aggregate;
+    GtkWidget *         widget;
+    guint               tick_id;
+} AgwValueChannelPrivate;
+
+struct _AgwValueChannel {
+    GObject parent_instance;
+};
+
+enum {
+    PROP_0,
+    PROP_WIDGET,
+    PROP_AGGREGATE,
+    NUM_PROPERTIES,
+};
+
+static GParamSpec *props[NUM_PROPERTIES] = { 0 };
+
+G_DEFINE_TYPE_WITH_PRIVATE(AgwValueChannel, agw_value_channel, G_TYPE_OBJECT)
+
+
+static gboolean
+is_pending(AgwValueChannelPrivate *priv)
+{
+    return (g_atomic_int_get(&priv->seq) & SEQ_DRAINED) == 0;
+}
+
+static void
+apply_summary(AgwValueChannel *channel, const AgwValueSummary *summary)
+{
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+    gdouble value;
+
+    switch (priv->aggregate) {
+    case AGW_VALUE_AGGREGATE_MIN:
+        value = summary->min;
+        break;
+    case AGW_VALUE_AGGREGATE_MAX:
+        value = summary->max;
+        break;
+    case AGW_VALUE_AGGREGATE_MEAN:
+        value = summary->sum / summary->count;
+        break;
+    default:
+        value = summary->last;
+        break;
+    }
+
+    if (AGW_IS_GAUGE(priv->widget)) {
+        agw_gauge_set_value(AGW_GAUGE(priv->widget), value);
+    } else {
+        agw_numeric_label_set_value(AGW_NUMERIC_LABEL(priv->widget), value);
+    }
+}
+
+static gboolean
+drain_tick(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+    AgwValueChannel *channel = AGW_VALUE_CHANNEL(user_data);
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+    AgwValueSummary summary;
+
+    if (agw_value_channel_drain(channel, &summary)) {
+        apply_summary(channel, &summary);
+        return G_SOURCE_CONTINUE;
+    }
+
+    /* Nothing new: stop ticking, unless a value slipped in after the
+     * drain and before the producer could see the channel disarmed */
+    g_atomic_int_set(&priv->armed, FALSE);
+    if (is_pending(priv) && g_atomic_int_compare_and_exchange(&priv->armed, FALSE, TRUE)) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Called whenever the tick callback goes away, including when GTK
+ * drops it because the widget has been destroyed */
+static void
+tick_removed(gpointer user_data)
+{
+    AgwValueChannel *channel = AGW_VALUE_CHANNEL(user_data);
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+
+    priv->tick_id = 0;
+    /* Let the next push wake the main loop up again */
+    g_atomic_int_set(&priv->armed, FALSE);
+    g_object_unref(channel);
+}
+
+static void
+start_ticking(AgwValueChannel *channel)
+{
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+
+    if (priv->widget != NULL && priv->tick_id == 0) {
+        priv->tick_id = gtk_widget_add_tick_callback(priv->widget, drain_tick,
+                                                     g_object_ref(channel),
+                                                     tick_removed);
+    }
+}
+
+/* Called in the main thread when the producer wakes the consumer up */
+static gboolean
+arm(gpointer user_data)
+{
+    start_ticking(AGW_VALUE_CHANNEL(user_data));
+    return G_SOURCE_REMOVE;
+}
+
+static void
+unbind(AgwValueChannel *channel)
+{
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+
+    if (priv->widget == NULL) {
+        return;
+    }
+
+    if (priv->tick_id != 0) {
+        gtk_widget_remove_tick_callback(priv->widget, priv->tick_id);
+    }
+    g_object_remove_weak_pointer(G_OBJECT(priv->widget), (gpointer *) &priv->widget);
+    priv->widget = NULL;
+}
+
+static void
+dispose(GObject *object)
+{
+    unbind(AGW_VALUE_CHANNEL(object));
+    G_OBJECT_CLASS(agw_value_channel_parent_class)->dispose(object);
+}
+
+static void
+get_property(GObject *object, guint prop_id,
+             GValue *value, GParamSpec *pspec)
+{
+    AgwValueChannel *channel = AGW_VALUE_CHANNEL(object);
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+
+    switch (prop_id) {
+    case PROP_WIDGET:
+        g_value_set_object(value, priv->widget);
+        break;
+    case PROP_AGGREGATE:
+        g_value_set_enum(value, priv->aggregate);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+set_property(GObject *object, guint prop_id,
+             const GValue *value, GParamSpec *pspec)
+{
+    AgwValueChannel *channel = AGW_VALUE_CHANNEL(object);
+
+    switch (prop_id) {
+    case PROP_WIDGET:
+        agw_value_channel_bind(channel, g_value_get_object(value));
+        break;
+    case PROP_AGGREGATE:
+        agw_value_channel_set_aggregate(channel, g_value_get_enum(value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+
+static void
+agw_value_channel_class_init(AgwValueChannelClass *class)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(class);
+
+    gobject_class->dispose = dispose;
+    gobject_class->get_property = get_property;
+    gobject_class->set_property = set_property;
+
+    props[PROP_WIDGET] = g_param_spec_object("widget",
+                                             "Widget",
+                                             "The AgwGauge or AgwNumericLabel fed by this channel",
+                                             GTK_TYPE_WIDGET,
+                                             G_PARAM_READWRITE);
+    props[PROP_AGGREGATE] = g_param_spec_enum("aggregate",
+                                              "Aggregate",
+                                              "Which value, among the ones pushed in a frame, is applied to the widget",
+                                              AGW_TYPE_VALUE_AGGREGATE,
+                                              AGW_VALUE_AGGREGATE_LAST,
+                                              G_PARAM_READWRITE);
+
+    g_object_class_install_properties(gobject_class, NUM_PROPERTIES, props);
+}
+
+static void
+agw_value_channel_init(AgwValueChannel *channel)
+{
+    AgwValueChannelPrivate *priv = agw_value_channel_get_instance_private(channel);
+
+    /* Nothing to drain yet */
+    priv->seq = SEQ_DRAINED;
+    priv->armed = FALSE;
+    priv->aggregate = AGW_VALUE_AGGREGATE_LAST;
+}
+
+
+/**
+ * agw_value_aggregate_get_type:
+ *
+ * Registers the #AgwValueAggregate enumeration in the type system.
+ *
+ * Returns: the #GType of #AgwValueAggregate
+ **/
+GType
+agw_value_aggregate_get_type(void)
+{
+    static gsize type = 0;
+
+    if (g_once_init_enter(&type)) {
+        static const GEnumValue values[] = {
+            { AGW_VALUE_AGGREGATE_LAST, "AGW_VALUE_AGGREGATE_LAST", "last" },
+            { AGW_VALUE_AGGREGATE_MIN,  "AGW_VALUE_AGGREGATE_MIN",  "min" },
+            { AGW_VALUE_AGGREGATE_MAX,  "AGW_VALUE_AGGREGATE_MAX",  "max" },
+            { AGW_VALUE_AGGREGATE_MEAN, "AGW_VALUE_AGGREGATE_MEAN", "mean" },
+            { 0, NULL, NULL }
+        };
+        GType id = g_enum_register_static(g_intern_static_string("AgwValueAggregate"),
+                                          values);
+        g_once_init_leave(&type, id);
+    }
+
+    return type;
+}
+
+/**
+ * agw_value_channel_new:
+ *
+ * Creates a new #AgwValueChannel, not bound to any widget.
+ *
+ * Returns: (transfer full): the newly created channel
+ **/
+AgwValueChannel *
+agw_value_channel_new(void)
+{
+    return g_object_new(AGW_TYPE_VALUE_CHANNEL, NULL);
+}
+
+/**
+ * agw_value_channel_push:
+ * @channel: an #AgwValueChannel
+ * @value: the new value
+ *
+ * Adds @value to the summary of @channel. This can be called from any
+ * thread, as long as it is always the same one, and never blocks nor
+ * allocates memory: the main loop is woken up only by the first value
+ * pushed after the bound widget stopped looking at the channel.
+ **/
+void
+agw_value_channel_push(AgwValueChannel *channel, gdouble value)
+{
+    AgwValueChannelPrivate *priv;
+    AgwValueSummary *summary;
+    guint seq;
+
+    g_return_if_fail(AGW_IS_VALUE_CHANNEL(channel));
+
+    priv = agw_value_channel_get_instance_private(channel);
+    summary = &priv->summary;
+
+    /* The consumer can only add SEQ_DRAINED, so this loops at most
+     * twice */
+    do {
+        seq = g_atomic_int_get(&priv->seq);
+    } while (!g_atomic_int_compare_and_exchange(&priv->seq, seq, seq | SEQ_WRITING));
+
+    if ((seq & SEQ_DRAINED) != 0) {
+        /* The previous summary has been consumed: start a new one */
+        summary->min = summary->max = summary->sum = value;
+        summary->count = 1;
+    } else {
+        if (value < summary->min) {
+            summary->min = value;
+        }
+        if (value > summary->max) {
+            summary->max = value;
+        }
+        summary->sum += value;
+        ++summary->count;
+    }
+    summary->last = value;
+
+    g_atomic_int_set(&priv->seq, (seq & ~SEQ_FLAGS) + SEQ_STEP);
+
+    if (g_atomic_int_compare_and_exchange(&priv->armed, FALSE, TRUE)) {
+        g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT, arm,
+                                   g_object_ref(channel), g_object_unref);
+    }
+}
+
+/**
+ * agw_value_channel_drain:
+ * @channel: an #AgwValueChannel
+ * @summary: (out): where to store the summary
+ *
+ * Gets the summary of the values pushed since the previous call and
+ * starts a new one. This is done automatically once per frame when a
+ * widget is bound to @channel, so only call it for unbound channels.
+ * It must always be called from the same thread, usually the main one.
+ *
+ * Returns: %TRUE if @summary has been set, %FALSE if no value has been
+ *          pushed in the meantime or the producer is busy writing it
+ **/
+gboolean
+agw_value_channel_drain(AgwValueChannel *channel, AgwValueSummary *summary)
+{
+    AgwValueChannelPrivate *priv;
+    AgwValueSummary copy;
+    guint seq;
+    gint n;
+
+    g_return_val_if_fail(AGW_IS_VALUE_CHANNEL(channel), FALSE);
+    g_return_val_if_fail(summary != NULL, FALSE);
+
+    priv = agw_value_channel_get_instance_private(channel);
+
+    for (n = 0; n < DRAIN_ATTEMPTS; ++n) {
+        seq = g_atomic_int_get(&priv->seq);
+        if ((seq & SEQ_DRAINED) != 0) {
+            return FALSE;
+        }
+        if ((seq & SEQ_WRITING) != 0) {
+            continue;
+        }
+        copy = priv->summary;
+        /* Fails if the producer touched the summary meanwhile */
+        if (g_atomic_int_compare_and_exchange(&priv->seq, seq, seq | SEQ_DRAINED)) {
+            *summary = copy;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * agw_value_channel_bind:
+ * @channel: an #AgwValueChannel
+ * @widget: (allow-none): an #AgwGauge or an #AgwNumericLabel
+ *
+ * Makes @channel feed @widget: once per frame, if any value has been
+ * pushed, the value selected by #AgwValueChannel:aggregate is set on
+ * @widget. Any previously bound widget is released: use %NULL to just
+ * unbind it. The binding is removed when @widget is destroyed.
+ **/
+void
+agw_value_channel_bind(AgwValueChannel *channel, GtkWidget *widget)
+{
+    AgwValueChannelPrivate *priv;
+
+    g_return_if_fail(AGW_IS_VALUE_CHANNEL(channel));
+    g_return_if_fail(widget == NULL || AGW_IS_GAUGE(widget) || AGW_IS_NUMERIC_LABEL(widget));
+
+    priv = agw_value_channel_get_instance_private(channel);
+    if (widget == priv->widget) {
+        return;
+    }
+
+    unbind(channel);
+    if (widget != NULL) {
+        priv->widget = widget;
+        g_object_add_weak_pointer(G_OBJECT(widget), (gpointer *) &priv->widget);
+        /* Apply what has been pushed so far, if anything */
+        g_atomic_int_set(&priv->armed, TRUE);
+        start_ticking(channel);
+    }
+
+    g_object_notify_by_pspec(G_OBJECT(channel), props[PROP_WIDGET]);
+}
+
+/**
+ * agw_value_channel_get_widget:
+ * @channel: an #AgwValueChannel
+ *
+ * Gets the widget fed by @channel.
+ *
+ * @return: (transfer none): the bound widget or %NULL
+ **/
+GtkWidget *
+agw_value_channel_get_widget(AgwValueChannel *channel)
+{
+    AgwValueChannelPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_VALUE_CHANNEL(channel), NULL);
+
+    priv = agw_value_channel_get_instance_private(channel);
+    return priv->widget;
+}
+
+/**
+ * agw_value_channel_set_aggregate:
+ * @channel: an #AgwValueChannel
+ * @aggregate: the new aggregate
+ *
+ * Selects which value is applied to the bound widget when more values
+ * have been pushed during a frame. The default is
+ * %AGW_VALUE_AGGREGATE_LAST.
+ **/
+void
+agw_value_channel_set_aggregate(AgwValueChannel *channel, AgwValueAggregate aggregate)
+{
+    AgwValueChannelPrivate *priv;
+
+    g_return_if_fail(AGW_IS_VALUE_CHANNEL(channel));
+    g_return_if_fail(aggregate >= AGW_VALUE_AGGREGATE_LAST &&
+                     aggregate <= AGW_VALUE_AGGREGATE_MEAN);
+
+    priv = agw_value_channel_get_instance_private(channel);
+    if (aggregate != priv->aggregate) {
+        priv->aggregate = aggregate;
+        g_object_notify_by_pspec(G_OBJECT(channel), props[PROP_AGGREGATE]);
+    }
+}
+
+/**
+ * agw_value_channel_get_aggregate:
+ * @channel: an #AgwValueChannel
+ *
+ * Gets the aggregate applied to the bound widget.
+ *
+ * @return: the current aggregate
+ **/
+AgwValueAggregate
+agw_value_channel_get_aggregate(AgwValueChannel *channel)
+{
+    AgwValueChannelPrivate *priv;
+
+    g_return_val_if_fail(AGW_IS_VALUE_CHANNEL(channel), AGW_VALUE_AGGREGATE_LAST);
+
+    priv = agw_value_channel_get_instance_private(channel);
+    return priv->aggregate;
+}
@@ -0,0 +1,90 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __AGW_VALUE_CHANNEL_H__
+#define __AGW_VALUE_CHANNEL_H__
+
+#include <gtk/gtk.h>
+
+
+G_BEGIN_DECLS
+
+/**
+ * AgwValueAggregate:
+ * @AGW_VALUE_AGGREGATE_LAST: the latest value
+ * @AGW_VALUE_AGGREGATE_MIN: the lowest value
+ * @AGW_VALUE_AGGREGATE_MAX: the highest value
+ * @AGW_VALUE_AGGREGATE_MEAN: the mean of the values
+ *
+ * Which value, among the ones pushed since the previous frame, is
+ * applied to the widget bound to an #AgwValueChannel.
+ **/
+typedef enum {
+    AGW_VALUE_AGGREGATE_LAST,
+    AGW_VALUE_AGGREGATE_MIN,
+    AGW_VALUE_AGGREGATE_MAX,
+    AGW_VALUE_AGGREGATE_MEAN,
+} AgwValueAggregate;
+
+/**
+ * AgwValueSummary:
+ * @last: the latest value
+ * @min: the lowest value
+ * @max: the highest value
+ * @sum: the sum of the values
+ * @count: how many values have been pushed
+ *
+ * The values pushed into an #AgwValueChannel since the previous
+ * agw_value_channel_drain() call.
+ **/
+typedef struct {
+    gdouble     last;
+    gdouble     min;
+    gdouble     max;
+    gdouble     sum;
+    guint       count;
+} AgwValueSummary;
+
+#define AGW_TYPE_VALUE_AGGREGATE agw_value_aggregate_get_type()
+#define AGW_TYPE_VALUE_CHANNEL agw_value_channel_get_type()
+
+GType           agw_value_aggregate_get_type(void) G_GNUC_CONST;
+
+G_DECLARE_FINAL_TYPE(AgwValueChannel, agw_value_channel, AGW, VALUE_CHANNEL, GObject)
+
+
+AgwValueChannel *
+                agw_value_channel_new       (void);
+void            agw_value_channel_push      (AgwValueChannel *  channel,
+                                             gdouble            value);
+gboolean        agw_value_channel_drain     (AgwValueChannel *  channel,
+                                             AgwValueSummary *  summary);
+void            agw_value_channel_bind      (AgwValueChannel *  channel,
+                                             GtkWidget *        widget);
+GtkWidget *     agw_value_channel_get_widget(AgwValueChannel *  channel);
+void            agw_value_channel_set_aggregate
+                                            (AgwValueChannel *  channel,
+                                             AgwValueAggregate  aggregate);
+AgwValueAggregate
+                agw_value_channel_get_aggregate
+                                            (AgwValueChannel *  channel);
+
+G_END_DECLS
+
+
+#endif /* __AGW_VALUE_CHANNEL_H__ */
@@ -17,7 +17,10 @@
  */
 
 #include "agw-gauge.h"
+#include "agw-gauge-grid.h"
 #include "agw-numeric-label.h"
+#include "agw-strip-chart.h"
+#include "agw-value-channel.h"
 
 
 /**
@@ -26,12 +29,15 @@
  * Initialize libagw.
  *
  * Using any widget from GtkBuilder requires it to be already present
- * in the type system, so this function ensures every AGW widget is
- * registered.
+ * in the type system, so this function ensures every AGW widget (and
+ * #AgwValueChannel) is registered.
  **/
 void
 agw_init(void)
 {
     g_type_ensure(AGW_TYPE_GAUGE);
+    g_type_ensure(AGW_TYPE_GAUGE_GRID);
     g_type_ensure(AGW_TYPE_NUMERIC_LABEL);
+    g_type_ensure(AGW_TYPE_STRIP_CHART);
+    g_type_ensure(AGW_TYPE_VALUE_CHANNEL);
 }
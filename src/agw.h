@@ -20,12 +20,55 @@
 #define __AGW_H__
 
 #include "agw-gauge.h"
+#include "agw-gauge-grid.h"
+#include "agw-gauge-renderer.h"
 #include "agw-numeric-label.h"
+#include "agw-strip-chart.h"
+#include "agw-value-channel.h"
 
 
 G_BEGIN_DECLS
 
+/**
+ * AgwStats:
+ * @draws: number of gauge draws
+ * @draw_time: total time spent drawing gauges, in microseconds
+ * @draw_time_max: longest gauge draw, in microseconds
+ * @redraws: number of redraws queued by the gauges
+ * @theme_loads: number of themes set on gauges
+ * @theme_load_time: total time spent setting themes, in microseconds
+ * @theme_cache_hits: themes found in the theme cache
+ * @theme_cache_misses: themes loaded from disk
+ * @layers_cache_hits: static layers found in the layer cache
+ * @layers_cache_misses: static layers rendered from scratch
+ * @label_updates: number of numeric label text updates
+ * @label_update_time: total time spent updating the numeric labels, in
+ *                     microseconds
+ *
+ * Performance counters collected when the `AGW_DEBUG` environment
+ * variable contains `perf`.
+ **/
+typedef struct {
+    guint64     draws;
+    gint64      draw_time;
+    gint64      draw_time_max;
+    guint64     redraws;
+    guint64     theme_loads;
+    gint64      theme_load_time;
+    guint64     theme_cache_hits;
+    guint64     theme_cache_misses;
+    guint64     layers_cache_hits;
+    guint64     layers_cache_misses;
+    guint64     label_updates;
+    gint64      label_update_time;
+} AgwStats;
+
+
 void        agw_init                (void);
+gboolean    agw_get_stats           (AgwStats *     stats);
+gboolean    agw_get_widget_stats    (GtkWidget *    widget,
+                                     AgwStats *     stats);
+void        agw_reset_stats         (void);
 
 G_END_DECLS
 
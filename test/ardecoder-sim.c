@@ -0,0 +1,429 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* ardecoder firmware simulator.
+ *
+ * Creates a pseudo-terminal and speaks the ardecoder line protocol on
+ * it, so the ardecoder program can be run without the real board:
+ *
+ *   ./ardecoder-sim --encoders 2 --profile sine --timestamps &
+ *   ./ardecoder --device /dev/pts/N --latency
+ *
+ * Lines sent by the simulator:
+ *   `#text`                comment (the banner is repeated every
+ *                          second until push mode is enabled)
+ *   `?text`                error
+ *   `n value homing`       data line of encoder n (1 based); with
+ *                          --timestamps a fourth field is appended,
+ *                          holding the CLOCK_MONOTONIC time (in us) of
+ *                          when the line has been written
+ *
+ * Commands accepted by the simulator:
+ *   `S<ms>`                push the data lines of every encoder each
+ *                          <ms> milliseconds, `S0` stops pushing;
+ *                          fractional values (e.g. `S0.25` for 4 kHz)
+ *                          are accepted, the real firmware does not
+ *   `<n>`                  send the data line of encoder n once
+ */
+
+#define _GNU_SOURCE
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define MAX_ENCODERS    16
+
+
+typedef enum {
+    PROFILE_STILL,
+    PROFILE_CONSTANT,
+    PROFILE_SINE,
+    PROFILE_STEP,
+    PROFILE_RANDOM,
+} Profile;
+
+
+static gint encoders = 1;
+static gint ppr = 2000;
+static gchar *profile_name = NULL;
+static gdouble speed = 0.5;
+static gdouble period = 0;
+static gboolean timestamps = FALSE;
+static gchar *link_path = NULL;
+
+static Profile profile = PROFILE_SINE;
+static gint random_value[MAX_ENCODERS];
+static gint64 start_time = 0;
+static guint64 dropped = 0;
+static volatile sig_atomic_t quit = 0;
+
+
+static void
+on_signal(int signum)
+{
+    quit = 1;
+}
+
+static gboolean
+parse_profile(const gchar *name)
+{
+    static const struct {
+        const gchar *   name;
+        Profile         profile;
+    } profiles[] = {
+        { "still",    PROFILE_STILL },
+        { "constant", PROFILE_CONSTANT },
+        { "sine",     PROFILE_SINE },
+        { "step",     PROFILE_STEP },
+        { "random",   PROFILE_RANDOM },
+    };
+    guint n;
+
+    if (name == NULL) {
+        return TRUE;
+    }
+
+    for (n = 0; n < G_N_ELEMENTS(profiles); ++n) {
+        if (g_strcmp0(profiles[n].name, name) == 0) {
+            profile = profiles[n].profile;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static gint
+get_value(gint n, gint64 now)
+{
+    /* Counts per revolution of a quadrature encoder */
+    gdouble cpr = 4. * ppr;
+    /* Every encoder is a bit out of phase from the previous one */
+    gdouble t = (now - start_time) / 1e6 + n * 0.1;
+
+    switch (profile) {
+
+    case PROFILE_STILL:
+        return 0;
+
+    case PROFILE_CONSTANT:
+        return speed * t * cpr;
+
+    case PROFILE_SINE:
+        return cpr * sin(2 * G_PI * speed * t);
+
+    case PROFILE_STEP:
+        /* Quarter of revolution steps */
+        return floor(4 * speed * t) * cpr / 4;
+
+    case PROFILE_RANDOM:
+        random_value[n] += g_random_int_range(-ppr / 50 - 1, ppr / 50 + 2);
+        return random_value[n];
+    }
+
+    return 0;
+}
+
+static gboolean
+is_homed(gint n, gint64 now)
+{
+    /* Homing is completed one second after the start */
+    return now - start_time > G_USEC_PER_SEC;
+}
+
+static void
+send_line(gint fd, const gchar *line)
+{
+    gsize len = strlen(line);
+
+    /* Nobody is reading the other end: drop the line instead of
+     * blocking, so the timings of the next lines are preserved */
+    if (write(fd, line, len) != (gssize) len) {
+        ++dropped;
+    }
+}
+
+static void
+send_data(gint fd, gint n)
+{
+    gchar line[64];
+    gint64 now = g_get_monotonic_time();
+
+    if (timestamps) {
+        g_snprintf(line, sizeof(line), "%d %d %d %" G_GINT64_FORMAT "\r\n",
+                   n + 1, get_value(n, now), is_homed(n, now), now);
+    } else {
+        g_snprintf(line, sizeof(line), "%d %d %d\r\n",
+                   n + 1, get_value(n, now), is_homed(n, now));
+    }
+    send_line(fd, line);
+}
+
+static void
+execute(gint fd, const gchar *command)
+{
+    gchar *end, *reply;
+    gdouble ms;
+    gint64 n;
+
+    if (command[0] == 'S') {
+        ms = g_ascii_strtod(command + 1, &end);
+        if (end == command + 1 || *end != '\0' || ms < 0) {
+            send_line(fd, "?Invalid push period\r\n");
+            return;
+        }
+        period = ms;
+        reply = g_strdup_printf("#Push period set to %g ms\r\n", period);
+        send_line(fd, reply);
+        g_free(reply);
+    } else if (g_ascii_isdigit(command[0])) {
+        n = g_ascii_strtoll(command, &end, 10);
+        if (*end != '\0' || n < 1 || n > encoders) {
+            send_line(fd, "?Invalid encoder\r\n");
+            return;
+        }
+        send_data(fd, n - 1);
+    } else if (command[0] != '\0') {
+        send_line(fd, "?Invalid command\r\n");
+    }
+}
+
+static void
+receive(gint fd, GString *buffer)
+{
+    gchar chunk[256];
+    gchar *eol;
+    gssize len;
+
+    len = read(fd, chunk, sizeof(chunk));
+    if (len <= 0) {
+        return;
+    }
+    g_string_append_len(buffer, chunk, len);
+
+    while ((eol = strchr(buffer->str, '\n')) != NULL) {
+        *eol = '\0';
+        g_strchomp(buffer->str);
+        execute(fd, buffer->str);
+        g_string_erase(buffer, 0, eol - buffer->str + 1);
+    }
+}
+
+static gint
+open_pty(gint *slave_fd)
+{
+    struct termios tio;
+    const gchar *slave;
+    gint fd;
+
+    fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0 ||
+        (slave = ptsname(fd)) == NULL) {
+        g_printerr("Unable to create the pseudo-terminal: %s\n", g_strerror(errno));
+        return -1;
+    }
+
+    /* Keep the slave open, so the master does not get EIO while no
+     * client is connected, and make it raw: no echo, no line editing */
+    *slave_fd = open(slave, O_RDWR | O_NOCTTY);
+    if (*slave_fd < 0 || tcgetattr(*slave_fd, &tio) != 0) {
+        g_printerr("Unable to configure '%s': %s\n", slave, g_strerror(errno));
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(*slave_fd, TCSANOW, &tio);
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    if (link_path != NULL) {
+        g_unlink(link_path);
+        if (symlink(slave, link_path) != 0) {
+            g_printerr("Unable to create '%s': %s\n", link_path, g_strerror(errno));
+        }
+    }
+
+    g_print("%s\n", slave);
+    return fd;
+}
+
+static void
+run(gint fd)
+{
+    GString *buffer = g_string_new(NULL);
+    struct pollfd pfd;
+    struct timespec timeout;
+    gint64 now, next_push, next_banner, wait;
+    gint n;
+
+    start_time = g_get_monotonic_time();
+    next_push = next_banner = start_time;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    while (!quit) {
+        now = g_get_monotonic_time();
+
+        if (period > 0 && now >= next_push) {
+            for (n = 0; n < encoders; ++n) {
+                send_data(fd, n);
+            }
+            /* Do not try to recover lost periods, e.g. after a stop */
+            next_push += period * 1000;
+            if (next_push < now) {
+                next_push = now + period * 1000;
+            }
+        }
+
+        if (period <= 0 && now >= next_banner) {
+            send_line(fd, "#ardecoder simulator\r\n");
+            next_banner = now + G_USEC_PER_SEC;
+        }
+
+        /* Sleep until the next event: ppoll() has sub-millisecond
+         * resolution, needed by push rates in the kHz range */
+        wait = period > 0 ? next_push - now : next_banner - now;
+        wait = CLAMP(wait, 0, G_USEC_PER_SEC);
+        timeout.tv_sec = wait / G_USEC_PER_SEC;
+        timeout.tv_nsec = (wait % G_USEC_PER_SEC) * 1000;
+        if (ppoll(&pfd, 1, &timeout, NULL) > 0 && (pfd.revents & POLLIN)) {
+            receive(fd, buffer);
+        }
+        if (period <= 0) {
+            next_push = g_get_monotonic_time();
+        }
+    }
+
+    g_string_free(buffer, TRUE);
+}
+
+int
+main(int argc, char **argv)
+{
+    GOptionEntry options[] = {{
+        "encoders",                 /* long_name */
+        'n',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_INT,           /* arg */
+        &encoders,                  /* arg_data */
+        "Number of simulated encoders",
+        "N"                         /* arg_description */
+    }, {
+        "ppr",                      /* long_name */
+        'p',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_INT,           /* arg */
+        &ppr,                       /* arg_data */
+        "Pulses per revolution",    /* description */
+        "N"                         /* arg_description */
+    }, {
+        "profile",                  /* long_name */
+        'm',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_STRING,        /* arg */
+        &profile_name,              /* arg_data */
+        "Motion profile: still, constant, sine (default), step or random",
+        "PROFILE"                   /* arg_description */
+    }, {
+        "speed",                    /* long_name */
+        's',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_DOUBLE,        /* arg */
+        &speed,                     /* arg_data */
+        "Speed (or frequency) of the motion, in revolutions per second",
+        "RPS"                       /* arg_description */
+    }, {
+        "period",                   /* long_name */
+        't',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_DOUBLE,        /* arg */
+        &period,                    /* arg_data */
+        "Push period before any S command, 0 to wait for it",
+        "MS"                        /* arg_description */
+    }, {
+        "timestamps",               /* long_name */
+        'T',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_NONE,          /* arg */
+        &timestamps,                /* arg_data */
+        "Append the sending time to every data line",
+        NULL                        /* arg_description */
+    }, {
+        "link",                     /* long_name */
+        'l',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_FILENAME,      /* arg */
+        &link_path,                 /* arg_data */
+        "Create a symbolic link to the pseudo-terminal",
+        "PATH"                      /* arg_description */
+    }, {
+        NULL
+    }};
+    GOptionContext *context;
+    GError *error;
+    gint fd, slave_fd;
+
+    context = g_option_context_new("- simulate an ardecoder board");
+    g_option_context_add_main_entries(context, options, NULL);
+    error = NULL;
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("%s\n", error->message);
+        g_error_free(error);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    if (!parse_profile(profile_name)) {
+        g_printerr("Invalid motion profile '%s'\n", profile_name);
+        return 1;
+    }
+    if (encoders < 1 || encoders > MAX_ENCODERS) {
+        g_printerr("The number of encoders must be between 1 and %d\n", MAX_ENCODERS);
+        return 1;
+    }
+
+    fd = open_pty(&slave_fd);
+    if (fd < 0) {
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    run(fd);
+
+    if (dropped > 0) {
+        g_printerr("%" G_GUINT64_FORMAT " lines dropped\n", dropped);
+    }
+    if (link_path != NULL) {
+        g_unlink(link_path);
+    }
+    close(slave_fd);
+    close(fd);
+    g_free(profile_name);
+    g_free(link_path);
+    return 0;
+}
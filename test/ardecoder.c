@@ -18,22 +18,115 @@
 
 #include <gtk/gtk.h>
 #include <libserialport.h>
+#include <errno.h>
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include "../src/agw-gauge.h"
+#include "../src/agw-value-channel.h"
 
-#define THREAD_QUIT()   g_atomic_int_set(&quit, TRUE)
+#define READER_SIZE     4096
+/* Same limit as ardecoder-sim */
+#define MAX_ENCODERS    16
 
+/* Recordings start with this magic and are followed by Record structs,
+ * in the byte order of the host that wrote them */
+#define RECORD_MAGIC    "ARDREC1\n"
+#define RECORD_HOMED    (1 << 0)
 
-static gchar *device = NULL;
+
+typedef struct {
+    guint               gauge;
+    gint                value;
+    /* When the line has been sent, 0 if not known */
+    gint64              sent;
+} Sample;
+
+typedef struct {
+    /* Monotonic time the sample has been received at, in us */
+    gint64              time;
+    gint32              value;
+    guint16             gauge;
+    guint16             flags;
+} Record;
+
+G_STATIC_ASSERT(sizeof(Record) == 16);
+
+/* Bytes received from the serial port: data lines are consumed from
+ * `start` while new bytes are appended at `end` */
+typedef struct {
+    gchar               data[READER_SIZE];
+    gsize               start;
+    gsize               end;
+} Reader;
+
+typedef struct {
+    const gchar *       device;
+    struct sp_port *    port;
+    GSource *           source;
+    gpointer            tag;
+    gboolean            failed;
+    gboolean            boot;
+    /* Index of the gauge of encoder 1 */
+    guint               first_gauge;
+    Reader              reader;
+} Board;
+
+typedef struct {
+    GSource             source;
+    Board *             board;
+} SerialSource;
+
+typedef struct {
+    gint64              counter;
+    gint64              oldest;
+    gint64              newest;
+} Frame;
+
+
+static gchar **devices = NULL;
+static gint encoders = 1;
 static gint ppr = 2000;
 static gboolean inverted = FALSE;
-static GtkWidget *gauge = NULL;
-static volatile gboolean quit = FALSE;
-static GThread *encoder1_thread = NULL;
+static gdouble period = 100;
+static gboolean latency = FALSE;
+static GtkWidget **gauges = NULL;
+static guint n_gauges = 0;
+static gboolean worker = FALSE;
+static Board *boards = NULL;
+static guint n_boards = 0;
+
+/* Only used with --worker */
+static GMainContext *worker_context = NULL;
+static GMainLoop *worker_loop = NULL;
+static GThread *worker_thread = NULL;
+/* One per gauge, plus one for the sending times with --latency */
+static AgwValueChannel **channels = NULL;
+static AgwValueChannel *sent_channel = NULL;
+
+static gchar *record_path = NULL;
+static FILE *record_file = NULL;
+
+static gchar *replay_path = NULL;
+static gdouble replay_speed = 1;
+static GMappedFile *replay_file = NULL;
+static const Record *records = NULL;
+static gsize n_records = 0;
+static gsize replay_pos = 0;
+static gint64 replay_start = 0;
+static GSource *replay_source = NULL;
+
+/* Latency measurement, only accessed from the main thread */
+static gint64 pending_oldest = 0;
+static gint64 pending_newest = 0;
+static guint samples = 0;
+static GQueue frames = G_QUEUE_INIT;
+static GArray *oldest_latencies = NULL;
+static GArray *newest_latencies = NULL;
 
 
 static void
-serial_error(struct sp_port *port)
+serial_error(const gchar *device, struct sp_port *port)
 {
     if (port == NULL) {
         g_warning("\"%s\" is not a valid serial device", device);
@@ -46,10 +139,10 @@ serial_error(struct sp_port *port)
 }
 
 static void
-serial_abort(struct sp_port *port)
+serial_abort(Board *board)
 {
-    serial_error(port);
-    THREAD_QUIT();
+    serial_error(board->device, board->port);
+    board->failed = TRUE;
 }
 
 static void
@@ -62,7 +155,7 @@ serial_close(struct sp_port *port)
 }
 
 static struct sp_port *
-serial_open(void)
+serial_open(const gchar *device)
 {
     struct sp_port *port = NULL;
 
@@ -75,7 +168,7 @@ serial_open(void)
         sp_set_parity(port, SP_PARITY_NONE) != SP_OK ||
         sp_set_flowcontrol(port, SP_FLOWCONTROL_RTSCTS) != SP_OK) {
         /* Error while opening the serial communication */
-        serial_error(port);
+        serial_error(device, port);
         serial_close(port);
         return NULL;
     }
@@ -83,114 +176,670 @@ serial_open(void)
     return port;
 }
 
-static gchar *
-serial_receive(struct sp_port *port, guint timeout)
+/* Appends to the reader whatever has been received, without waiting.
+ * Returns FALSE on errors. */
+static gboolean
+serial_receive(Board *board)
 {
-    gchar byte;
+    Reader *reader = &board->reader;
     int status;
-    GString *string = g_string_sized_new(10);
-
-    for (;;) {
-        status = sp_blocking_read(port, &byte, 1, timeout);
-        if (status < 0) {
-            /* Error while receiving: abort the thread */
-            serial_abort(port);
-            g_string_free(string, TRUE);
-            return NULL;
-        } else if (status == 0) {
-            /* Timeout: just return NULL */
-            g_string_free(string, TRUE);
-            return NULL;
+
+    /* Make room for new data by moving the partial line on top */
+    if (reader->start > 0) {
+        memmove(reader->data, reader->data + reader->start,
+                reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    if (reader->end == READER_SIZE) {
+        g_warning("Line too long from \"%s\" device: discarded", board->device);
+        reader->end = 0;
+    }
+
+    status = sp_nonblocking_read(board->port, reader->data + reader->end,
+                                 READER_SIZE - reader->end);
+    if (status < 0) {
+        /* Error while receiving: stop watching the port */
+        serial_abort(board);
+        return FALSE;
+    }
+    reader->end += status;
+    return TRUE;
+}
+
+/* Returns the next complete line, NUL terminated and without EOL
+ * characters, or NULL if there are no more lines. The line is split in
+ * place inside `reader`, so it is valid only until serial_receive() is
+ * called again. */
+static const gchar *
+serial_next_line(Reader *reader)
+{
+    gchar *line, *eol;
+
+    line = reader->data + reader->start;
+    eol = memchr(line, '\n', reader->end - reader->start);
+    if (eol == NULL) {
+        return NULL;
+    }
+
+    reader->start = eol - reader->data + 1;
+    *eol = '\0';
+    if (eol > line && eol[-1] == '\r') {
+        eol[-1] = '\0';
+    }
+    return line;
+}
+
+static gboolean
+parse_int(const gchar **text, gint64 *value)
+{
+    const gchar *p = *text;
+    gboolean negative;
+    gint64 result, digit;
+
+    while (*p == ' ' || *p == '\t') {
+        ++p;
+    }
+
+    negative = *p == '-';
+    if (*p == '-' || *p == '+') {
+        ++p;
+    }
+    if (!g_ascii_isdigit(*p)) {
+        return FALSE;
+    }
+
+    result = 0;
+    while (g_ascii_isdigit(*p)) {
+        digit = *p - '0';
+        if (result > (G_MAXINT64 - digit) / 10) {
+            /* Corrupted line */
+            return FALSE;
         }
-        /* First timeout (from request to start of response) is custom.
-         * Subsequent bytes have 0,1 second fixed limit instead */
-        timeout = 100;
-        if (byte == '\n') {
+        result = result * 10 + digit;
+        ++p;
+    }
+
+    *value = negative ? -result : result;
+    *text = p;
+    return TRUE;
+}
+
+/* Parses a "n value homing [sent]" data line and returns the number
+ * of fields found */
+static gint
+parse_data(const gchar *line, gint64 *fields, gint n_fields)
+{
+    gint n;
+
+    for (n = 0; n < n_fields; ++n) {
+        if (!parse_int(&line, &fields[n])) {
             break;
-        } else if (byte != '\r') {
-            string = g_string_append_c(string, byte);
         }
     }
-    return g_string_free(string, FALSE);
+
+    return n;
 }
 
 static gboolean
-serial_send(struct sp_port *port, const gchar *text)
+serial_send(Board *board, const gchar *text)
 {
     int count = strlen(text);
-    size_t status = sp_blocking_write(port, text, count, 500);
+    int status = sp_blocking_write(board->port, text, count, 500);
     if (status < 0) {
-        /* Error while sending: abort the thread */
-        serial_abort(port);
+        /* Error while sending: stop watching the port */
+        serial_abort(board);
         return FALSE;
     } else if (status != count) {
-        /* Timeout in sending: abort the thread */
-        g_warning("Timeout sending \"%s\" to \"%s\" device", text, device);
-        THREAD_QUIT();
+        /* Timeout in sending: stop watching the port */
+        g_warning("Timeout sending \"%s\" to \"%s\" device", text, board->device);
+        board->failed = TRUE;
         return FALSE;
     }
     return TRUE;
 }
 
+static void
+apply_sample(const Sample *sample)
+{
+    GtkWidget *gauge = gauges[sample->gauge];
+
+    /* During shutdown `gauge` can be already destroyed */
+    if (gauge != NULL) {
+        agw_gauge_set_value(AGW_GAUGE(gauge), sample->value);
+    }
+
+    /* Keep track of the samples that will be shown by the next frame */
+    if (sample->sent > 0) {
+        if (pending_oldest == 0) {
+            pending_oldest = sample->sent;
+        }
+        pending_newest = sample->sent;
+    }
+    ++samples;
+}
+
+/* The path followed by every sample, live or replayed */
+static void
+deliver_sample(const Sample *sample)
+{
+    if (worker_context == NULL) {
+        /* Already in the GTK main context */
+        apply_sample(sample);
+        return;
+    }
+
+    /* From the worker: the gauges pick the latest values once per frame */
+    agw_value_channel_push(channels[sample->gauge], sample->value);
+    if (sent_channel != NULL && sample->sent > 0) {
+        agw_value_channel_push(sent_channel, sample->sent);
+    }
+}
+
+static void
+record_sample(const Sample *sample, gboolean homed)
+{
+    Record record;
+
+    record.time = g_get_monotonic_time();
+    record.value = sample->value;
+    record.gauge = sample->gauge;
+    record.flags = homed ? RECORD_HOMED : 0;
+
+    /* Buffered by stdio: a syscall every few hundred samples */
+    if (fwrite(&record, sizeof(record), 1, record_file) != 1) {
+        g_warning("Unable to write to '%s': recording stopped", record_path);
+        fclose(record_file);
+        record_file = NULL;
+    }
+}
+
+static void
+handle_line(Board *board, const gchar *line)
+{
+    gchar *command;
+    gchar number[G_ASCII_DTOSTR_BUF_SIZE];
+    gint64 fields[4];
+    Sample sample;
+
+    if (line[0] == '#') {
+        /* Comment */
+        g_message("[%s] %s", board->device, line + 1);
+        if (board->boot) {
+            /* ardecoder up and running: enable push-mode */
+            /* The board wants a dot, whatever the locale is */
+            command = g_strdup_printf("S%s\n",
+                                      g_ascii_formatd(number, sizeof(number), "%g", period));
+            serial_send(board, command);
+            g_free(command);
+            serial_send(board, "1\n");
+            board->boot = FALSE;
+        }
+    } else if (line[0] == '?') {
+        /* Error */
+        g_warning("[%s] %s", board->device, line + 1);
+    } else {
+        /* Data line, optionally followed by the sending time */
+        fields[3] = 0;
+        if (parse_data(line, fields, G_N_ELEMENTS(fields)) < 3 ||
+            fields[1] < G_MININT32 || fields[1] > G_MAXINT32) {
+            g_warning("[%s] Invalid data line \"%s\"", board->device, line);
+            return;
+        }
+        g_debug("[%s] Encoder %d: %d%s", board->device, (gint) fields[0],
+                (gint) fields[1], fields[2] ? "" : " not homed");
+        if (fields[0] < 1 || fields[0] > encoders) {
+            /* No gauge for this encoder */
+            return;
+        }
+        sample.gauge = board->first_gauge + fields[0] - 1;
+        sample.value = fields[1];
+        sample.sent = fields[3];
+        if (record_file != NULL) {
+            record_sample(&sample, fields[2] != 0);
+        }
+        deliver_sample(&sample);
+    }
+}
+
 static gboolean
-update_gauge(gpointer user_data)
+serial_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
 {
-    /* During shutdown `gauge` can be invalid */
-    if (AGW_IS_GAUGE(gauge)) {
-        agw_gauge_set_value(AGW_GAUGE(gauge), GPOINTER_TO_INT(user_data));
+    Board *board = ((SerialSource *) source)->board;
+    const gchar *line;
+
+    if (g_source_query_unix_fd(source, board->tag) & (G_IO_ERR | G_IO_HUP)) {
+        g_warning("\"%s\" device disconnected", board->device);
+        return G_SOURCE_REMOVE;
     }
-    return G_SOURCE_REMOVE;
+
+    if (!serial_receive(board)) {
+        return G_SOURCE_REMOVE;
+    }
+    while ((line = serial_next_line(&board->reader)) != NULL) {
+        handle_line(board, line);
+        if (board->failed) {
+            return G_SOURCE_REMOVE;
+        }
+    }
+
+    return G_SOURCE_CONTINUE;
 }
 
-static gpointer
-encoder_loop(gpointer user_data)
+static GSourceFuncs serial_source_funcs = {
+    NULL,                       /* prepare */
+    NULL,                       /* check */
+    serial_source_dispatch,     /* dispatch */
+    NULL,                       /* finalize */
+};
+
+/* Wakes up only when the port has something to read: no polling and
+ * no timeouts are involved */
+static GSource *
+serial_source_new(Board *board)
 {
-    gchar *line;
-    gint n, value, homing;
-    struct sp_port *port;
-    gboolean boot = TRUE;
+    GSource *source;
+    int fd;
 
-    port = serial_open();
-    if (port == NULL) {
+    if (sp_get_port_handle(board->port, &fd) != SP_OK) {
+        serial_error(board->device, board->port);
         return NULL;
     }
 
-    while (g_atomic_int_get(&quit) == FALSE) {
-        line = serial_receive(port, 1000);
-        if (line == NULL) {
-            /* Timeout: do nothing */
-        } else if (line[0] == '#') {
-            /* Comment */
-            g_message("%s", line + 1);
-            if (boot) {
-                /* ardecoder up and running: enable push-mode (0,1 s) */
-                serial_send(port, "S100\n");
-                serial_send(port, "1\n");
-                boot = FALSE;
+    source = g_source_new(&serial_source_funcs, sizeof(SerialSource));
+    ((SerialSource *) source)->board = board;
+    g_source_set_name(source, board->device);
+    board->tag = g_source_add_unix_fd(source, fd, G_IO_IN | G_IO_ERR | G_IO_HUP);
+
+    return source;
+}
+
+static gpointer
+worker_run(gpointer user_data)
+{
+    g_main_context_push_thread_default(worker_context);
+    g_main_loop_run(worker_loop);
+    g_main_context_pop_thread_default(worker_context);
+    return NULL;
+}
+
+static void
+start_io(void)
+{
+    Board *board;
+    guint n;
+
+    if (worker) {
+        worker_context = g_main_context_new();
+        worker_loop = g_main_loop_new(worker_context, FALSE);
+        channels = g_new(AgwValueChannel *, n_gauges);
+        for (n = 0; n < n_gauges; ++n) {
+            channels[n] = agw_value_channel_new();
+            agw_value_channel_bind(channels[n], gauges[n]);
+        }
+    }
+
+    n_boards = g_strv_length(devices);
+    boards = g_new0(Board, n_boards);
+    for (n = 0; n < n_boards; ++n) {
+        board = &boards[n];
+        board->device = devices[n];
+        board->boot = TRUE;
+        board->first_gauge = n * encoders;
+        board->port = serial_open(devices[n]);
+        if (board->port != NULL) {
+            board->source = serial_source_new(board);
+        }
+        if (board->source != NULL) {
+            g_source_attach(board->source, worker_context);
+        }
+    }
+
+    if (worker) {
+        worker_thread = g_thread_new("io", worker_run, NULL);
+    }
+}
+
+static void
+stop_io(void)
+{
+    Board *board;
+    guint n;
+
+    /* The worker is always sleeping in poll(): quitting is immediate */
+    if (worker_thread != NULL) {
+        g_main_loop_quit(worker_loop);
+        g_thread_join(worker_thread);
+        worker_thread = NULL;
+    }
+
+    for (n = 0; n < n_boards; ++n) {
+        board = &boards[n];
+        if (board->source != NULL) {
+            g_source_destroy(board->source);
+            g_source_unref(board->source);
+        }
+        serial_close(board->port);
+    }
+    g_free(boards);
+    boards = NULL;
+    n_boards = 0;
+
+    if (worker_loop != NULL) {
+        g_main_loop_unref(worker_loop);
+        g_main_context_unref(worker_context);
+        worker_loop = NULL;
+        worker_context = NULL;
+        for (n = 0; n < n_gauges; ++n) {
+            agw_value_channel_bind(channels[n], NULL);
+            g_object_unref(channels[n]);
+        }
+        g_free(channels);
+        channels = NULL;
+    }
+}
+
+/* Appends to `record_path`, writing the magic if it is a new file */
+static gboolean
+start_record(void)
+{
+    gchar magic[sizeof(RECORD_MAGIC)];
+    gsize magic_size;
+    long size;
+
+    record_file = fopen(record_path, "a+b");
+    if (record_file == NULL || fseek(record_file, 0, SEEK_END) != 0 ||
+        (size = ftell(record_file)) < 0) {
+        g_warning("Unable to open '%s': %s", record_path, g_strerror(errno));
+        goto error;
+    }
+
+    magic_size = strlen(RECORD_MAGIC);
+    if (size == 0) {
+        if (fwrite(RECORD_MAGIC, magic_size, 1, record_file) != 1) {
+            g_warning("Unable to write to '%s': %s", record_path, g_strerror(errno));
+            goto error;
+        }
+        return TRUE;
+    }
+
+    /* Do not append samples to something else */
+    rewind(record_file);
+    if ((gsize) size < magic_size ||
+        fread(magic, magic_size, 1, record_file) != 1 ||
+        memcmp(magic, RECORD_MAGIC, magic_size) != 0 ||
+        (size - magic_size) % sizeof(Record) != 0) {
+        g_warning("'%s' is not a valid recording", record_path);
+        goto error;
+    }
+
+    /* Required when switching from reading to writing */
+    fseek(record_file, 0, SEEK_END);
+    return TRUE;
+
+error:
+    if (record_file != NULL) {
+        fclose(record_file);
+        record_file = NULL;
+    }
+    return FALSE;
+}
+
+static void
+stop_record(void)
+{
+    if (record_file != NULL) {
+        fclose(record_file);
+        record_file = NULL;
+    }
+}
+
+static gboolean
+load_replay(void)
+{
+    GError *error;
+    const gchar *contents;
+    gsize size, magic_size, n;
+
+    error = NULL;
+    replay_file = g_mapped_file_new(replay_path, FALSE, &error);
+    if (replay_file == NULL) {
+        g_warning("%s", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+
+    contents = g_mapped_file_get_contents(replay_file);
+    size = g_mapped_file_get_length(replay_file);
+    magic_size = strlen(RECORD_MAGIC);
+    if (size < magic_size || memcmp(contents, RECORD_MAGIC, magic_size) != 0 ||
+        (size - magic_size) % sizeof(Record) != 0) {
+        g_warning("'%s' is not a valid recording", replay_path);
+        g_mapped_file_unref(replay_file);
+        replay_file = NULL;
+        return FALSE;
+    }
+
+    /* The mapping is page aligned and the magic is 8 bytes long, so
+     * the records are properly aligned */
+    records = (const Record *) (contents + magic_size);
+    n_records = (size - magic_size) / sizeof(Record);
+
+    /* Create enough gauges for the recording */
+    for (n = 0; n < n_records; ++n) {
+        n_gauges = MAX(n_gauges, records[n].gauge + 1u);
+    }
+
+    return TRUE;
+}
+
+static void
+replay_record(const Record *record)
+{
+    Sample sample;
+
+    sample.gauge = record->gauge;
+    sample.value = record->value;
+    sample.sent = 0;
+    deliver_sample(&sample);
+}
+
+static gboolean
+replay_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
+{
+    gint64 now, due, elapsed;
+
+    now = g_get_monotonic_time();
+
+    if (replay_speed > 0) {
+        /* Feed everything that is due, then sleep until the next one */
+        for (; replay_pos < n_records; ++replay_pos) {
+            due = replay_start +
+                  (records[replay_pos].time - records[0].time) / replay_speed;
+            if (due > now) {
+                g_source_set_ready_time(source, due);
+                return G_SOURCE_CONTINUE;
+            }
+            replay_record(&records[replay_pos]);
+        }
+    } else {
+        /* Maximum speed: feed in 10 ms slices, to let GTK draw */
+        while (replay_pos < n_records) {
+            replay_record(&records[replay_pos]);
+            ++replay_pos;
+            if ((replay_pos & 0xFF) == 0 && g_get_monotonic_time() - now > 10000) {
+                return G_SOURCE_CONTINUE;
             }
-        } else if (line[0] == '?') {
-            /* Error */
-            g_warning("%s", line + 1);
-        } else {
-            /* Data line */
-            sscanf(line, "%d %d %d", &n, &value, &homing);
-            g_debug("Encoder %d: %d%s", n, value, homing ? "" : " not homed");
-            g_main_context_invoke(NULL, update_gauge, GINT_TO_POINTER(value));
         }
-        g_free(line);
     }
 
-    serial_close(port);
-    return NULL;
+    elapsed = g_get_monotonic_time() - replay_start;
+    g_print("Replayed %" G_GSIZE_FORMAT " samples in %.3f s (%.0f samples/s)\n",
+            n_records, elapsed / 1e6,
+            elapsed > 0 ? n_records * 1e6 / elapsed : 0.);
+
+    /* At maximum speed this is a benchmark: done */
+    if (replay_speed <= 0) {
+        g_application_quit(g_application_get_default());
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+static GSourceFuncs replay_source_funcs = {
+    NULL,                       /* prepare */
+    NULL,                       /* check */
+    replay_dispatch,            /* dispatch */
+    NULL,                       /* finalize */
+};
+
+static void
+start_replay(void)
+{
+    if (n_records == 0) {
+        return;
+    }
+
+    replay_pos = 0;
+    replay_start = g_get_monotonic_time();
+    replay_source = g_source_new(&replay_source_funcs, sizeof(GSource));
+    g_source_set_name(replay_source, "replay");
+    /* At maximum speed, the source is always ready */
+    g_source_set_ready_time(replay_source, 0);
+    g_source_attach(replay_source, NULL);
+}
+
+static void
+stop_replay(void)
+{
+    if (replay_source != NULL) {
+        g_source_destroy(replay_source);
+        g_source_unref(replay_source);
+        replay_source = NULL;
+    }
+    if (replay_file != NULL) {
+        g_mapped_file_unref(replay_file);
+        replay_file = NULL;
+        records = NULL;
+        n_records = 0;
+    }
+}
+
+static gint
+compare_latency(gconstpointer a, gconstpointer b)
+{
+    gint64 la = *(const gint64 *) a;
+    gint64 lb = *(const gint64 *) b;
+    return la < lb ? -1 : la > lb;
+}
+
+static void
+print_latencies(const gchar *name, GArray *latencies)
+{
+    gint64 *data = (gint64 *) latencies->data;
+    guint len = latencies->len;
+
+    if (len == 0) {
+        return;
+    }
+
+    g_array_sort(latencies, compare_latency);
+    g_print("  %s sample: min %.2f  median %.2f  p99 %.2f  max %.2f ms\n",
+            name, data[0] / 1000., data[len / 2] / 1000.,
+            data[len * 99 / 100] / 1000., data[len - 1] / 1000.);
+    g_array_set_size(latencies, 0);
 }
 
+static gboolean
+report_latency(gpointer user_data)
+{
+    g_print("%u samples/s, %u frames/s\n", samples, oldest_latencies->len);
+    print_latencies("oldest", oldest_latencies);
+    print_latencies("newest", newest_latencies);
+    samples = 0;
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+on_after_paint(GdkFrameClock *clock, gpointer user_data)
+{
+    GdkFrameTimings *timings;
+    Frame *frame;
+    gint64 presented;
+
+    /* Remember which samples went into this frame */
+    if (pending_oldest != 0) {
+        timings = gdk_frame_clock_get_current_timings(clock);
+        frame = g_new(Frame, 1);
+        frame->counter = gdk_frame_timings_get_frame_counter(timings);
+        frame->oldest = pending_oldest;
+        frame->newest = pending_newest;
+        g_queue_push_tail(&frames, frame);
+        pending_oldest = pending_newest = 0;
+    }
+
+    /* Presentation times are known only some frame later */
+    while ((frame = g_queue_peek_head(&frames)) != NULL) {
+        timings = gdk_frame_clock_get_timings(clock, frame->counter);
+        if (timings != NULL && !gdk_frame_timings_get_complete(timings)) {
+            break;
+        }
+        g_queue_pop_head(&frames);
+        if (timings != NULL) {
+            /* Not all backends know when a frame is on screen */
+            presented = gdk_frame_timings_get_presentation_time(timings);
+            if (presented == 0) {
+                presented = gdk_frame_timings_get_frame_time(timings);
+            }
+            presented -= frame->oldest;
+            g_array_append_val(oldest_latencies, presented);
+            presented += frame->oldest - frame->newest;
+            g_array_append_val(newest_latencies, presented);
+        }
+        g_free(frame);
+    }
+}
+
+/* With --worker, the sending times come through a channel */
 static void
+on_update(GdkFrameClock *clock, gpointer user_data)
+{
+    AgwValueSummary summary;
+
+    if (sent_channel != NULL && agw_value_channel_drain(sent_channel, &summary)) {
+        if (pending_oldest == 0) {
+            pending_oldest = summary.min;
+        }
+        pending_newest = summary.last;
+        samples += summary.count;
+    }
+}
+
+static void
+start_latency(void)
+{
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(gauges[0]);
+
+    oldest_latencies = g_array_new(FALSE, FALSE, sizeof(gint64));
+    newest_latencies = g_array_new(FALSE, FALSE, sizeof(gint64));
+    if (worker) {
+        sent_channel = agw_value_channel_new();
+        g_signal_connect(clock, "update", G_CALLBACK(on_update), NULL);
+    }
+    g_signal_connect(clock, "after-paint", G_CALLBACK(on_after_paint), NULL);
+    g_timeout_add_seconds(1, report_latency, NULL);
+}
+
+static GtkWidget *
 create_gauge(void)
 {
+    GtkWidget *gauge;
     GError *error;
     gchar *theme;
 
     gauge = agw_gauge_new();
+    gtk_widget_set_hexpand(gauge, TRUE);
+    gtk_widget_set_vexpand(gauge, TRUE);
     /* A quadrature encoder has four AB states for every phase pulse
      * (00, 01, 10 and 11), so the total resolution is `4ppr`.
      * Splitting by 2ppr per side here. */
@@ -207,41 +856,92 @@ create_gauge(void)
         g_log(g_quark_to_string(error->domain), G_LOG_LEVEL_CRITICAL,
               "[%d]: %s", error->code, error->message);
         g_error_free(error);
-        g_object_unref(G_OBJECT(gauge));
+        g_object_ref_sink(gauge);
+        g_object_unref(gauge);
+        return NULL;
     }
+
+    return gauge;
 }
 
 static void
 on_activate(GtkApplication *app)
 {
-    GtkWidget *window;
+    GtkWidget *window, *grid;
+    guint columns, n;
 
-    create_gauge();
-    if (gauge == NULL) {
-        /* Error while creating the gauge widget: bail out */
+    /* One gauge per encoder per board, in a roughly square grid */
+    n_gauges = MAX(devices != NULL ? g_strv_length(devices) : 0, 1) * encoders;
+    if (replay_path != NULL && !load_replay()) {
         return;
     }
+    columns = ceil(sqrt(n_gauges));
+    gauges = g_new0(GtkWidget *, n_gauges);
+
+    grid = gtk_grid_new();
+    for (n = 0; n < n_gauges; ++n) {
+        gauges[n] = create_gauge();
+        if (gauges[n] == NULL) {
+            /* Error while creating the gauge widget: bail out */
+            g_object_ref_sink(grid);
+            g_object_unref(grid);
+            return;
+        }
+        /* Reset to NULL when destroyed, so late samples are dropped */
+        g_object_add_weak_pointer(G_OBJECT(gauges[n]), (gpointer *) &gauges[n]);
+        gtk_grid_attach(GTK_GRID(grid), gauges[n], n % columns, n / columns, 1, 1);
+    }
 
     /* Create the user interface */
     window = gtk_application_window_new(app);
     gtk_window_set_default_size(GTK_WINDOW(window), 600, 480);
-    gtk_container_add(GTK_CONTAINER(window), gauge);
+    gtk_container_add(GTK_CONTAINER(window), grid);
     gtk_widget_show_all(window);
 
-    /* Start the encoder thread, if requested */
-    if (device != NULL) {
-        encoder1_thread = g_thread_new("encoder1", encoder_loop, NULL);
+    /* The simulator must be started with --timestamps */
+    if (latency) {
+        start_latency();
+    }
+
+    if (record_path != NULL && !start_record()) {
+        return;
+    }
+
+    /* Start watching the boards, if requested */
+    if (devices != NULL) {
+        start_io();
+    }
+
+    if (replay_file != NULL) {
+        start_replay();
     }
 }
 
+static gint
+on_handle_local_options(GApplication *app, GVariantDict *options)
+{
+    if (encoders < 1 || encoders > MAX_ENCODERS) {
+        g_printerr("The number of encoders must be between 1 and %d\n", MAX_ENCODERS);
+        return 1;
+    }
+
+    /* Go on with the default processing */
+    return -1;
+}
+
 static void
 on_shutdown(GtkApplication *app)
 {
-    if (encoder1_thread != NULL) {
-        THREAD_QUIT();
-        g_thread_join(encoder1_thread);
-        encoder1_thread = NULL;
+    stop_replay();
+    stop_io();
+    stop_record();
+    g_queue_clear_full(&frames, g_free);
+    if (oldest_latencies != NULL) {
+        g_array_free(oldest_latencies, TRUE);
+        g_array_free(newest_latencies, TRUE);
+        oldest_latencies = newest_latencies = NULL;
     }
+    g_clear_object(&sent_channel);
 }
 
 int
@@ -251,10 +951,50 @@ main(int argc, char **argv)
         "device",                   /* long_name */
         'd',                        /* short_name */
         G_OPTION_FLAG_IN_MAIN,      /* flags */
-        G_OPTION_ARG_FILENAME,      /* arg */
-        &device,                    /* arg_data */
-        "ardecoder serial device",  /* description */
+        G_OPTION_ARG_FILENAME_ARRAY,/* arg */
+        &devices,                   /* arg_data */
+        "ardecoder serial device (can be repeated)",
         "DEVICE"                    /* arg_description */
+    }, {
+        "encoders",                 /* long_name */
+        'e',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_INT,           /* arg */
+        &encoders,                  /* arg_data */
+        "Encoders per device",      /* description */
+        "N"                         /* arg_description */
+    }, {
+        "worker",                   /* long_name */
+        'w',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_NONE,          /* arg */
+        &worker,                    /* arg_data */
+        "Read the devices from a worker thread",
+        NULL                        /* arg_description */
+    }, {
+        "record",                   /* long_name */
+        'r',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_FILENAME,      /* arg */
+        &record_path,               /* arg_data */
+        "Append the received samples to FILE",
+        "FILE"                      /* arg_description */
+    }, {
+        "replay",                   /* long_name */
+        'R',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_FILENAME,      /* arg */
+        &replay_path,               /* arg_data */
+        "Replay the samples recorded in FILE",
+        "FILE"                      /* arg_description */
+    }, {
+        "speed",                    /* long_name */
+        's',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_DOUBLE,        /* arg */
+        &replay_speed,              /* arg_data */
+        "Replay speed factor, 0 to replay as fast as possible and quit",
+        "N"                         /* arg_description */
     }, {
         "ppr",                      /* long_name */
         'p',                        /* short_name */
@@ -271,6 +1011,22 @@ main(int argc, char **argv)
         &inverted,                  /* arg_data */
         "Invert gauge movement",    /* description */
         NULL                        /* arg_description */
+    }, {
+        "period",                   /* long_name */
+        'P',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_DOUBLE,        /* arg */
+        &period,                    /* arg_data */
+        "Push period requested to the board",
+        "MS"                        /* arg_description */
+    }, {
+        "latency",                  /* long_name */
+        'L',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_NONE,          /* arg */
+        &latency,                   /* arg_data */
+        "Report the latency from sample to screen",
+        NULL                        /* arg_description */
     }, {
         NULL
     }};
@@ -279,6 +1035,7 @@ main(int argc, char **argv)
 
     app = gtk_application_new("com.entidi.ardecoder", G_APPLICATION_FLAGS_NONE);
     g_application_add_main_option_entries(G_APPLICATION(app), options);
+    g_signal_connect(app, "handle-local-options", G_CALLBACK(on_handle_local_options), NULL);
     g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
     g_signal_connect(app, "shutdown", G_CALLBACK(on_shutdown), NULL);
     status = g_application_run(G_APPLICATION(app), argc, argv);
@@ -0,0 +1,151 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Tests of the AgwNumericFormat fast paths: whatever the format and the
+ * value, the result must be the same as g_snprintf(). */
+
+#include <glib.h>
+#include <math.h>
+#include <string.h>
+#include "../src/agw-numeric-format.h"
+
+#define N_RANDOM    20000
+
+
+static const gchar *formats[] = {
+    "%f", "%F", "%.0f", "%.1f", "%.2f", "%.3f", "%.9f", "%.12f",
+    "%#.0f", "%+.3f", "% .4f", "%-9.2f|", "%012.9f", "%+012.3f", "%8.1f",
+    "%g", "%G", "%.0g", "%.1g", "%.2g", "%.3g", "%.9g", "%.12g",
+    "%#g", "%#.1g", "%#.3g", "%+g", "% g", "%-12g|", "%012g",
+    "%+012.4g", "%-#10.2G|", "%10.5g",
+    "%e", "%'f", "Value: %.2f V",
+};
+
+/* Rounding ties, powers of 10 and values near the fast path limits */
+static const gdouble values[] = {
+    0, 1, 0.5, 1.5, 2.5, 9.5, 0.95, 0.125, 0.375, 2.675, 1.005,
+    0.1, 0.2, 0.3, 1e-4, 1e-5, 5e-5, 0.000099999995, 9.9999995,
+    99999.95, 999999.5, 123456, 1234567, 1e9, 1e12 - 0.5,
+    999999999999.9, 1e12, 1e15, 1e22, 1e-22, 1e300, 1e-300,
+    G_MAXDOUBLE, G_MINDOUBLE,
+};
+
+
+static void
+assert_same(const AgwNumericFormat *compiled, const gchar *format, gdouble value)
+{
+    gchar expected[512], result[512];
+    gsize len;
+
+    g_snprintf(expected, sizeof(expected), format, value);
+    len = agw_numeric_format_print(compiled, value, result, sizeof(result));
+    if (g_strcmp0(result, expected) != 0) {
+        g_test_message("\"%s\" with %.17g", format, value);
+    }
+    g_assert_cmpstr(result, ==, expected);
+    g_assert_cmpuint(len, ==, strlen(expected));
+}
+
+static void
+assert_same_signed(const AgwNumericFormat *compiled, const gchar *format, gdouble value)
+{
+    assert_same(compiled, format, value);
+    assert_same(compiled, format, -value);
+}
+
+static void
+test_values(void)
+{
+    AgwNumericFormat *compiled;
+    guint n, i;
+
+    for (n = 0; n < G_N_ELEMENTS(formats); ++n) {
+        compiled = agw_numeric_format_new(formats[n]);
+        g_assert_nonnull(compiled);
+        for (i = 0; i < G_N_ELEMENTS(values); ++i) {
+            /* Also covers negative zero */
+            assert_same_signed(compiled, formats[n], values[i]);
+            assert_same_signed(compiled, formats[n], nextafter(values[i], G_MAXDOUBLE));
+            assert_same_signed(compiled, formats[n], nextafter(values[i], 0));
+        }
+        assert_same(compiled, formats[n], INFINITY);
+        assert_same(compiled, formats[n], -INFINITY);
+        agw_numeric_format_free(compiled);
+    }
+}
+
+static void
+test_random(void)
+{
+    AgwNumericFormat *compiled;
+    GRand *rand;
+    gdouble value;
+    guint n, i;
+
+    /* A fixed seed, so failures can be reproduced */
+    rand = g_rand_new_with_seed(1);
+
+    for (n = 0; n < G_N_ELEMENTS(formats); ++n) {
+        compiled = agw_numeric_format_new(formats[n]);
+        for (i = 0; i < N_RANDOM; ++i) {
+            switch (i % 4) {
+            case 0:
+                /* Any magnitude around the %g fast path range */
+                value = g_rand_double(rand) * pow(10, g_rand_int_range(rand, -25, 25));
+                break;
+            case 1:
+                /* Few decimals, often close to a tie */
+                value = g_rand_int_range(rand, 0, 1000000) / pow(10, g_rand_int_range(rand, 0, 8));
+                break;
+            case 2:
+                /* Exact binary fractions, right on a tie */
+                value = g_rand_int_range(rand, 0, 100000) / 8.0;
+                break;
+            default:
+                /* Large values near the %f fast path limit */
+                value = g_rand_double_range(rand, 0, 2e12);
+                break;
+            }
+            assert_same_signed(compiled, formats[n], value);
+        }
+        agw_numeric_format_free(compiled);
+    }
+
+    g_rand_free(rand);
+}
+
+static void
+test_invalid(void)
+{
+    g_assert_null(agw_numeric_format_new("%d"));
+    g_assert_null(agw_numeric_format_new("%*f"));
+    g_assert_null(agw_numeric_format_new("%f %f"));
+    g_assert_null(agw_numeric_format_new("%Lf"));
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/numeric-format/values", test_values);
+    g_test_add_func("/numeric-format/random", test_random);
+    g_test_add_func("/numeric-format/invalid", test_invalid);
+
+    return g_test_run();
+}
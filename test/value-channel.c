@@ -0,0 +1,174 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* Tests of AgwValueChannel. The widget tests need a display and are
+ * skipped when none is available (run them under xvfb-run on headless
+ * machines). */
+
+#include <gtk/gtk.h>
+#include "../src/agw-numeric-label.h"
+#include "../src/agw-value-channel.h"
+
+#define N_VALUES    1000000
+#define TIMEOUT     (2 * G_TIME_SPAN_SECOND)
+
+
+static gboolean has_display = FALSE;
+
+
+static gpointer
+produce(gpointer user_data)
+{
+    AgwValueChannel *channel = AGW_VALUE_CHANNEL(user_data);
+    guint n;
+
+    for (n = 1; n <= N_VALUES; ++n) {
+        agw_value_channel_push(channel, n);
+    }
+
+    return NULL;
+}
+
+static void
+test_drain(void)
+{
+    AgwValueChannel *channel = agw_value_channel_new();
+    AgwValueSummary summary;
+
+    g_assert_false(agw_value_channel_drain(channel, &summary));
+
+    agw_value_channel_push(channel, 2);
+    agw_value_channel_push(channel, 1);
+    agw_value_channel_push(channel, 3);
+    g_assert_true(agw_value_channel_drain(channel, &summary));
+    g_assert_cmpuint(summary.count, ==, 3);
+    g_assert_cmpfloat(summary.min, ==, 1);
+    g_assert_cmpfloat(summary.max, ==, 3);
+    g_assert_cmpfloat(summary.sum, ==, 6);
+    g_assert_cmpfloat(summary.last, ==, 3);
+    g_assert_false(agw_value_channel_drain(channel, &summary));
+
+    /* A new summary is started after every drain */
+    agw_value_channel_push(channel, 5);
+    g_assert_true(agw_value_channel_drain(channel, &summary));
+    g_assert_cmpuint(summary.count, ==, 1);
+    g_assert_cmpfloat(summary.min, ==, 5);
+
+    g_object_unref(channel);
+}
+
+static void
+test_drain_concurrent(void)
+{
+    AgwValueChannel *channel = agw_value_channel_new();
+    AgwValueSummary summary;
+    GThread *producer;
+    guint64 count;
+    gdouble sum, last;
+    gboolean done;
+
+    producer = g_thread_new("producer", produce, channel);
+
+    /* Every value must be delivered exactly once */
+    count = 0;
+    sum = 0;
+    last = 0;
+    do {
+        done = last == N_VALUES;
+        if (agw_value_channel_drain(channel, &summary)) {
+            g_assert_cmpfloat(summary.min, >, last);
+            count += summary.count;
+            sum += summary.sum;
+            last = summary.last;
+            done = FALSE;
+        }
+    } while (!done);
+
+    g_thread_join(producer);
+    g_assert_false(agw_value_channel_drain(channel, &summary));
+    g_assert_cmpuint(count, ==, N_VALUES);
+    g_assert_cmpfloat(sum, ==, (gdouble) N_VALUES * (N_VALUES + 1) / 2);
+
+    g_object_unref(channel);
+}
+
+static gboolean
+wait_for_value(AgwNumericLabel *label, gdouble value)
+{
+    gint64 end = g_get_monotonic_time() + TIMEOUT;
+
+    while (g_get_monotonic_time() < end) {
+        if (agw_numeric_label_get_value(label) == value) {
+            return TRUE;
+        }
+        g_main_context_iteration(NULL, FALSE);
+        g_usleep(1000);
+    }
+
+    return FALSE;
+}
+
+static void
+test_rebind(void)
+{
+    AgwValueChannel *channel;
+    GtkWidget *window, *label;
+
+    if (!has_display) {
+        g_test_skip("no display available");
+        return;
+    }
+
+    channel = agw_value_channel_new();
+    window = gtk_offscreen_window_new();
+    gtk_widget_show(window);
+
+    label = agw_numeric_label_new();
+    gtk_container_add(GTK_CONTAINER(window), label);
+    gtk_widget_show(label);
+    agw_value_channel_bind(channel, label);
+    agw_value_channel_push(channel, 1);
+    g_assert_true(wait_for_value(AGW_NUMERIC_LABEL(label), 1));
+
+    /* Destroying the widget must not leave the channel stuck */
+    gtk_widget_destroy(label);
+    g_assert_null(agw_value_channel_get_widget(channel));
+
+    label = agw_numeric_label_new();
+    gtk_container_add(GTK_CONTAINER(window), label);
+    gtk_widget_show(label);
+    agw_value_channel_bind(channel, label);
+    agw_value_channel_push(channel, 2);
+    g_assert_true(wait_for_value(AGW_NUMERIC_LABEL(label), 2));
+
+    gtk_widget_destroy(window);
+    g_object_unref(channel);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    has_display = gtk_init_check(&argc, &argv);
+
+    g_test_add_func("/value-channel/drain", test_drain);
+    g_test_add_func("/value-channel/drain-concurrent", test_drain_concurrent);
+    g_test_add_func("/value-channel/rebind", test_rebind);
+
+    return g_test_run();
+}
@@ -0,0 +1,154 @@
+/* libagw - Additional GTK Widgets
+ * Copyright (C) 2026  Nicola Fontana <ntd@entidi.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/* agw-theme-compile: compiles a gauge theme into a theme pack.
+ *
+ * Loading a theme directory parses every SVG element with librsvg,
+ * that can dominate the startup time on slow machines. A theme pack
+ * contains the static layers and the hand sprites already rasterized
+ * at the given sizes, so it can be memory mapped and painted without
+ * parsing anything:
+ *
+ *   agw-theme-compile --sizes 64,128,200 --scales 1,2 theme/ theme.agwpack
+ *
+ * The resulting file can be passed to agw_gauge_set_theme() (and to
+ * any other function accepting a theme directory). The pack must be
+ * compiled on a machine with the same byte order of the target one.
+ * The default theme is embedded in this tool too, so it can be compiled
+ * by passing resource:///org/entidi/agw/assets as theme directory.
+ */
+
+#include "../src/agw-gauge-theme.h"
+#include "../src/agw-gauge-pack.h"
+
+
+#define MAX_SIZE    4096
+#define MAX_SCALE   8
+
+
+static gchar *sizes_text = NULL;
+static gchar *scales_text = NULL;
+
+
+static GArray *
+parse_list(const gchar *text, gint max)
+{
+    GArray *list;
+    gchar **tokens;
+    gchar *end;
+    gint64 value;
+    gint i, n;
+
+    list = g_array_new(FALSE, FALSE, sizeof(gint));
+    tokens = g_strsplit(text, ",", -1);
+
+    for (i = 0; tokens[i] != NULL; ++i) {
+        value = g_ascii_strtoll(g_strstrip(tokens[i]), &end, 10);
+        if (end == tokens[i] || *end != '\0' || value < 1 || value > max) {
+            g_array_free(list, TRUE);
+            list = NULL;
+            break;
+        }
+        n = value;
+        g_array_append_val(list, n);
+    }
+
+    g_strfreev(tokens);
+    return list;
+}
+
+int
+main(int argc, char **argv)
+{
+    GOptionEntry options[] = {{
+        "sizes",                    /* long_name */
+        's',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_STRING,        /* arg */
+        &sizes_text,                /* arg_data */
+        "Comma separated sizes to rasterize, in logical pixels (default: 64,100,128,200,256)",
+        "LIST"                      /* arg_description */
+    }, {
+        "scales",                   /* long_name */
+        'S',                        /* short_name */
+        G_OPTION_FLAG_IN_MAIN,      /* flags */
+        G_OPTION_ARG_STRING,        /* arg */
+        &scales_text,               /* arg_data */
+        "Comma separated scale factors to rasterize (default: 1)",
+        "LIST"                      /* arg_description */
+    }, {
+        NULL
+    }};
+    GOptionContext *context;
+    AgwGaugeTheme *theme;
+    GArray *sizes, *scales;
+    GError *error;
+    gboolean success;
+
+    context = g_option_context_new("THEME_DIR PACK - compile a gauge theme");
+    g_option_context_set_description(context,
+        "THEME_DIR can also be a resource:// URI, e.g.\n"
+        "resource:///org/entidi/agw/assets for the default theme.");
+    g_option_context_add_main_entries(context, options, NULL);
+    error = NULL;
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("%s\n", error->message);
+        g_error_free(error);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    if (argc != 3) {
+        g_printerr("Usage: %s [OPTION...] THEME_DIR PACK\n", g_get_prgname());
+        return 1;
+    }
+
+    sizes = parse_list(sizes_text != NULL ? sizes_text : "64,100,128,200,256", MAX_SIZE);
+    if (sizes == NULL) {
+        g_printerr("The sizes must be integers between 1 and %d\n", MAX_SIZE);
+        return 1;
+    }
+    scales = parse_list(scales_text != NULL ? scales_text : "1", MAX_SCALE);
+    if (scales == NULL) {
+        g_printerr("The scale factors must be integers between 1 and %d\n", MAX_SCALE);
+        return 1;
+    }
+
+    theme = agw_gauge_theme_load(argv[1], &error);
+    if (theme == NULL) {
+        g_printerr("Unable to load '%s': %s\n", argv[1], error->message);
+        g_error_free(error);
+        return 1;
+    }
+
+    success = agw_gauge_pack_write(theme,
+                                   (const gint *) sizes->data, sizes->len,
+                                   (const gint *) scales->data, scales->len,
+                                   argv[2], &error);
+    if (!success) {
+        g_printerr("Unable to write '%s': %s\n", argv[2], error->message);
+        g_error_free(error);
+    }
+
+    agw_gauge_theme_unref(theme);
+    g_array_free(sizes, TRUE);
+    g_array_free(scales, TRUE);
+    g_free(sizes_text);
+    g_free(scales_text);
+    return success ? 0 : 1;
+}